@@ -1,9 +1,12 @@
 #pragma once
 #include <cstdint>
 #include <cstdio>
+#include <cstdlib>
 #include <string>
+#include <vector>
 
 using std::string;
+using std::vector;
 
 
 
@@ -20,6 +23,8 @@ inline void helpGraphFormats() {
   fprintf(stderr, "  csv       Comma-separated values format.\n");
   fprintf(stderr, "  tsv       Tab-separated values format.\n");
   fprintf(stderr, "  adj       Adjacency graph format (CSR).\n");
+  fprintf(stderr, "  bin       Binary CSR format (memory mapped).\n");
+  fprintf(stderr, "  gen       Random graph, as input only (-i <kind>[:n=,m=,p=,d=,a=,b=,c=,seed=,u]).\n");
   fprintf(stderr, "\n");
 }
 
@@ -35,6 +40,24 @@ inline void showUsage(const char *details) {
 }
 
 
+/**
+ * Parse a size in bytes, with an optional K, M, or G suffix (powers of 1024).
+ * @param x size text, e.g. "512M"
+ * @returns size in bytes, or 0 if invalid
+ */
+inline size_t parseBytes(const string& x) {
+  char *end = nullptr;
+  unsigned long long a = strtoull(x.c_str(), &end, 10);
+  if (end==x.c_str()) return 0;
+  string s = end;
+  if (s=="" || s=="B") return size_t(a);
+  if (s=="K" || s=="k") return size_t(a) << 10;
+  if (s=="M" || s=="m") return size_t(a) << 20;
+  if (s=="G" || s=="g") return size_t(a) << 30;
+  return 0;
+}
+
+
 /**
  * Validate the input file.
  * @param x input file name
@@ -70,12 +93,37 @@ inline bool isOutputFile(const string &x, const char *details="-o, --output <fil
  * @returns true if the graph format is valid
  */
 inline bool isGraphFormat(const string &x, const char *details="-f, --format <format>") {
-  if (x=="mtx" || x=="coo" || x=="edgelist" || x=="csv" || x=="tsv" || x=="adj") return true;
+  if (x=="mtx" || x=="coo" || x=="edgelist" || x=="csv" || x=="tsv" || x=="adj" || x=="bin") return true;
   fprintf(stderr, "Unknown graph format '%s'\n\n", x.c_str());
   showUsage(details);
   helpGraphFormats();
   return false;
 }
+
+
+/**
+ * Validate an input graph format (a graph format, or a random graph).
+ * @param x graph format
+ * @param details details of the option
+ * @returns true if the graph format can be read
+ */
+inline bool isInputGraphFormat(const string &x, const char *details="-f, --input-format <format>") {
+  return x=="gen" || isGraphFormat(x, details);
+}
+
+
+/**
+ * Validate a graph format, for streaming through disk (text formats except adj).
+ * @param x graph format
+ * @param details details of the option
+ * @returns true if the graph format can be streamed
+ */
+inline bool isStreamFormat(const string &x, const char *details="-f, --format <format>") {
+  if (x=="mtx" || x=="coo" || x=="edgelist" || x=="csv" || x=="tsv") return true;
+  fprintf(stderr, "Graph format '%s' cannot be streamed with --memory-limit\n\n", x.c_str());
+  showUsage(details);
+  return false;
+}
 #pragma endregion
 
 
@@ -105,10 +153,16 @@ struct OptionsNoOperation {
   bool inputWeighted = false;
   /** Whether the output graph is weighted. */
   bool outputWeighted = false;
+  /** Whether edge weights are kept in double precision (else single). */
+  bool doubleWeights = false;
   /** Whether the input graph is symmetric. */
   bool inputSymmetric = false;
   /** Whether the output graph is symmetric. */
   bool outputSymmetric = false;
+  /** Whether to show the time and memory of each phase. */
+  bool profile = false;
+  /** File to write the time and memory of each phase to (JSON). */
+  string profileFile = "";
 };
 
 
@@ -129,8 +183,11 @@ inline void helpNoOperation(const char *name) {
   fprintf(stderr, "  -q, --output-sequential       Write output file sequentially [false].\n");
   fprintf(stderr, "  -w, --input-weighted          Input graph is weighted [false].\n");
   fprintf(stderr, "  -x, --output-weighted         Output graph is weighted [false].\n");
+  fprintf(stderr, "  -D, --double-weights          Keep edge weights in double precision [false].\n");
   fprintf(stderr, "  -s, --input-symmetric         Input graph is symmetric [false].\n");
   fprintf(stderr, "  -t, --output-symmetric        Output graph is symmetric [false].\n");
+  fprintf(stderr, "  -p, --profile                 Show time and memory of each phase [false].\n");
+  fprintf(stderr, "  -j, --profile-json <file>     Write time and memory of each phase as JSON.\n");
   fprintf(stderr, "\n");
   helpGraphFormats();
 }
@@ -157,15 +214,18 @@ inline OptionsNoOperation parseOptionsNoOperation(int argc, char **argv, int i=1
     else if (k=="-q" || k=="--output-sequential") o.outputSequential = true;
     else if (k=="-w" || k=="--input-weighted")   o.inputWeighted   = true;
     else if (k=="-x" || k=="--output-weighted")  o.outputWeighted  = true;
+    else if (k=="-D" || k=="--double-weights")   o.doubleWeights   = true;
     else if (k=="-s" || k=="--input-symmetric")  o.inputSymmetric  = true;
     else if (k=="-t" || k=="--output-symmetric") o.outputSymmetric = true;
+    else if (k=="-p" || k=="--profile") o.profile = true;
+    else if (k=="-j" || k=="--profile-json") o.profileFile = argv[++i];
     else { fprintf(stderr, "Unknown option '%s'\n\n", k.c_str()); return o; }
   }
   // Validate options.
   if (o.help) return o;
   if (!isInputFile(o.inputFile)) return o;
   if (!isOutputFile(o.outputFile)) return o;
-  if (!isGraphFormat(o.inputFormat, "-f, --input-format <format>")) return o;
+  if (!isInputGraphFormat(o.inputFormat)) return o;
   if (!isGraphFormat(o.outputFormat, "-g, --output-format <format>")) return o;
   o.valid = true;
   return o;
@@ -198,6 +258,10 @@ struct OptionsCountDisconnectedCommunities {
   bool weighted = false;
   /** Whether the input graph is symmetric. */
   bool symmetric = false;
+  /** Whether to show the time and memory of each phase. */
+  bool profile = false;
+  /** File to write the time and memory of each phase to (JSON). */
+  string profileFile = "";
 };
 
 
@@ -218,6 +282,8 @@ inline void helpCountDisconnectedCommunities(const char *name) {
   fprintf(stderr, "  -r, --membership-start       Community membership start index.\n");
   fprintf(stderr, "  -w, --weighted               Input graph is weighted.\n");
   fprintf(stderr, "  -s, --symmetric              Input graph is symmetric.\n");
+  fprintf(stderr, "  -p, --profile                Show time and memory of each phase.\n");
+  fprintf(stderr, "  -j, --profile-json <file>    Write time and memory of each phase as JSON.\n");
   fprintf(stderr, "\n");
   helpGraphFormats();
 }
@@ -244,12 +310,93 @@ inline OptionsCountDisconnectedCommunities parseCountDisconnectedCommunities(int
     else if (k=="-r" || k=="--membership-start") o.membershipStart = atoi(argv[++i]);
     else if (k=="-w" || k=="--weighted")  o.weighted  = true;
     else if (k=="-s" || k=="--symmetric") o.symmetric = true;
+    else if (k=="-p" || k=="--profile") o.profile = true;
+    else if (k=="-j" || k=="--profile-json") o.profileFile = argv[++i];
     else { fprintf(stderr, "Unknown option '%s'\n\n", k.c_str()); return o; }
   }
   // Validate options.
   if (o.help) return o;
   if (!isInputFile(o.inputFile)) return o;
-  if (!isGraphFormat(o.inputFormat, "-f, --input-format <format>")) return o;
+  if (!isInputGraphFormat(o.inputFormat)) return o;
+  o.valid = true;
+  return o;
+}
+#pragma endregion
+
+
+
+
+#pragma region COUNT COMPONENTS
+/**
+ * Command-line options for the count-components command.
+ */
+struct OptionsCountComponents {
+  /** Show help message? */
+  bool help = false;
+  /** Is it valid? */
+  bool valid = false;
+  /** Input file name. */
+  string inputFile = "";
+  /** Input file format (see supported formats). */
+  string inputFormat = "mtx";
+  /** Whether the input graph is weighted. */
+  bool weighted = false;
+  /** Whether the input graph is symmetric. */
+  bool symmetric = false;
+  /** Whether to show the time and memory of each phase. */
+  bool profile = false;
+  /** File to write the time and memory of each phase to (JSON). */
+  string profileFile = "";
+};
+
+
+/**
+ * Show help message for the count-components command.
+ * @param name program name
+ */
+inline void helpCountComponents(const char *name) {
+  fprintf(stderr, "%s count-components:\n", name);
+  fprintf(stderr, "Count the number of connected components in a graph, and report their sizes.\n");
+  fprintf(stderr, "\n");
+  fprintf(stderr, "Options:\n");
+  fprintf(stderr, "  -h, --help                   Show this help message.\n");
+  fprintf(stderr, "  -i, --input <file>           Input file name.\n");
+  fprintf(stderr, "  -f, --input-format <format>  Input file format.\n");
+  fprintf(stderr, "  -w, --weighted               Input graph is weighted.\n");
+  fprintf(stderr, "  -s, --symmetric              Input graph is symmetric.\n");
+  fprintf(stderr, "  -p, --profile                Show time and memory of each phase.\n");
+  fprintf(stderr, "  -j, --profile-json <file>    Write time and memory of each phase as JSON.\n");
+  fprintf(stderr, "\n");
+  helpGraphFormats();
+}
+
+
+/**
+ * Parse command line arguments for the count-components command.
+ * @param argc argument count
+ * @param argv argument values
+ * @param i start index of arguments [1]
+ * @returns options
+ */
+inline OptionsCountComponents parseCountComponents(int argc, char **argv, int i=1) {
+  OptionsCountComponents o;
+  // Parse command-line arguments.
+  for (; i<argc; ++i) {
+    string k = argv[i];
+    if (k=="") continue;
+    else if (k=="-h" || k=="--help") o.help = true;
+    else if (k=="-i" || k=="--input")  o.inputFile  = argv[++i];
+    else if (k=="-f" || k=="--input-format")  o.inputFormat  = argv[++i];
+    else if (k=="-w" || k=="--weighted")  o.weighted  = true;
+    else if (k=="-s" || k=="--symmetric") o.symmetric = true;
+    else if (k=="-p" || k=="--profile") o.profile = true;
+    else if (k=="-j" || k=="--profile-json") o.profileFile = argv[++i];
+    else { fprintf(stderr, "Unknown option '%s'\n\n", k.c_str()); return o; }
+  }
+  // Validate options.
+  if (o.help) return o;
+  if (!isInputFile(o.inputFile)) return o;
+  if (!isInputGraphFormat(o.inputFormat)) return o;
   o.valid = true;
   return o;
 }
@@ -281,10 +428,18 @@ struct OptionsMakeUndirected {
   bool inputWeighted = false;
   /** Whether the output graph is weighted. */
   bool outputWeighted = false;
+  /** Whether edge weights are kept in double precision (else single). */
+  bool doubleWeights = false;
   /** Whether the input graph is symmetric. */
   bool inputSymmetric = false;
   /** Whether the output graph is symmetric. */
   bool outputSymmetric = false;
+  /** Memory limit in bytes, for streaming through disk (0 to process in memory). */
+  size_t memoryLimit = 0;
+  /** Whether to show the time and memory of each phase. */
+  bool profile = false;
+  /** File to write the time and memory of each phase to (JSON). */
+  string profileFile = "";
 };
 
 
@@ -301,8 +456,13 @@ inline void helpMakeUndirectedOptions() {
   fprintf(stderr, "  -q, --output-sequential       Write output file sequentially [false].\n");
   fprintf(stderr, "  -w, --input-weighted          Input graph is weighted [false].\n");
   fprintf(stderr, "  -x, --output-weighted         Output graph is weighted [false].\n");
+  fprintf(stderr, "  -D, --double-weights          Keep edge weights in double precision [false].\n");
   fprintf(stderr, "  -s, --input-symmetric         Input graph is symmetric [false].\n");
   fprintf(stderr, "  -t, --output-symmetric        Output graph is symmetric [false].\n");
+  fprintf(stderr, "  -l, --memory-limit <bytes>    Stream through disk, using about this much memory,\n");
+  fprintf(stderr, "                                e.g. 512M (for text formats except adj) [0 => no].\n");
+  fprintf(stderr, "  -p, --profile                 Show time and memory of each phase [false].\n");
+  fprintf(stderr, "  -j, --profile-json <file>     Write time and memory of each phase as JSON.\n");
   fprintf(stderr, "\n");
 }
 
@@ -341,16 +501,25 @@ inline OptionsMakeUndirected parseOptionsMakeUndirected(int argc, char **argv, i
     else if (k=="-q" || k=="--output-sequential") o.outputSequential = true;
     else if (k=="-w" || k=="--input-weighted")   o.inputWeighted   = true;
     else if (k=="-x" || k=="--output-weighted")  o.outputWeighted  = true;
+    else if (k=="-D" || k=="--double-weights")   o.doubleWeights   = true;
     else if (k=="-s" || k=="--input-symmetric")  o.inputSymmetric  = true;
     else if (k=="-t" || k=="--output-symmetric") o.outputSymmetric = true;
+    else if (k=="-p" || k=="--profile") o.profile = true;
+    else if (k=="-j" || k=="--profile-json") o.profileFile = argv[++i];
+    else if (k=="-l" || k=="--memory-limit") {
+      o.memoryLimit = parseBytes(argv[++i]);
+      if (o.memoryLimit==0) { fprintf(stderr, "Invalid memory limit '%s'\n\n", argv[i]); return o; }
+    }
     else { fprintf(stderr, "Unknown option '%s'\n\n", k.c_str()); return o; }
   }
   // Validate options.
   if (o.help) return o;
   if (!isInputFile(o.inputFile)) return o;
   if (!isOutputFile(o.outputFile)) return o;
-  if (!isGraphFormat(o.inputFormat, "-f, --input-format <format>")) return o;
+  if (!isInputGraphFormat(o.inputFormat)) return o;
   if (!isGraphFormat(o.outputFormat, "-g, --output-format <format>")) return o;
+  if (o.memoryLimit && !isStreamFormat(o.inputFormat, "-f, --input-format <format>")) return o;
+  if (o.memoryLimit && !isStreamFormat(o.outputFormat, "-g, --output-format <format>")) return o;
   o.valid = true;
   return o;
 }
@@ -390,3 +559,600 @@ inline OptionsAddSelfLoops parseOptionsAddSelfLoops(int argc, char **argv, int i
   return parseOptionsMakeUndirected(argc, argv, i);
 }
 #pragma endregion
+
+
+
+
+#pragma region GENERATE
+/**
+ * Command-line options for the generate command.
+ */
+struct OptionsGenerate {
+  /** Show help message? */
+  bool help = false;
+  /** Is it valid? */
+  bool valid = false;
+  /** Kind of random graph (rmat, gnm, gnp, ba). */
+  string kind = "rmat";
+  /** Number of vertices (rounded up to a power of 2 for rmat). */
+  size_t vertices = 1000000;
+  /** Number of edges to generate (for rmat, gnm). */
+  size_t edges = 10000000;
+  /** Probability of each edge (for gnp). */
+  double probability = 0.00001;
+  /** Number of edges added by each vertex (for ba). */
+  size_t degree = 10;
+  /** Quadrant probabilities (for rmat). */
+  double pa = 0.57, pb = 0.19, pc = 0.19;
+  /** Random seed. */
+  uint64_t seed = 0;
+  /** Whether to add reverse edges, making the graph undirected. */
+  bool undirected = false;
+  /** Output file name. */
+  string outputFile = "";
+  /** Output file format (see supported formats). */
+  string outputFormat = "mtx";
+  /** Whether the output file should be written sequentially. */
+  bool outputSequential = false;
+  /** Whether the output graph is weighted (random weights). */
+  bool outputWeighted = false;
+  /** Whether edge weights are kept in double precision (else single). */
+  bool doubleWeights = false;
+  /** Whether the output graph is symmetric. */
+  bool outputSymmetric = false;
+  /** Whether to show the time and memory of each phase. */
+  bool profile = false;
+  /** File to write the time and memory of each phase to (JSON). */
+  string profileFile = "";
+};
+
+
+/**
+ * Show help message for the generate command.
+ * @param name program name
+ */
+inline void helpGenerate(const char *name) {
+  fprintf(stderr, "%s generate:\n", name);
+  fprintf(stderr, "Generate a random graph, reproducibly for any number of threads.\n");
+  fprintf(stderr, "\n");
+  fprintf(stderr, "Options:\n");
+  fprintf(stderr, "  -h, --help                     Show this help message.\n");
+  fprintf(stderr, "  -k, --kind <kind>              Kind of random graph [rmat].\n");
+  fprintf(stderr, "  -n, --vertices <count>         Number of vertices [1000000].\n");
+  fprintf(stderr, "  -m, --edges <count>            Number of edges, for rmat/gnm [10000000].\n");
+  fprintf(stderr, "  -e, --edge-probability <p>     Probability of each edge, for gnp [0.00001].\n");
+  fprintf(stderr, "  -d, --degree <count>           Edges added by each vertex, for ba [10].\n");
+  fprintf(stderr, "  -a, -b, -c <p>                 Quadrant probabilities, for rmat [0.57, 0.19, 0.19].\n");
+  fprintf(stderr, "  -r, --seed <seed>              Random seed [0].\n");
+  fprintf(stderr, "  -u, --undirected               Add reverse edges [false].\n");
+  fprintf(stderr, "  -o, --output <file>            Output file name.\n");
+  fprintf(stderr, "  -g, --output-format <format>   Output file format [mtx].\n");
+  fprintf(stderr, "  -q, --output-sequential        Write output file sequentially [false].\n");
+  fprintf(stderr, "  -x, --output-weighted          Output graph is weighted, with random weights [false].\n");
+  fprintf(stderr, "  -D, --double-weights           Keep edge weights in double precision [false].\n");
+  fprintf(stderr, "  -t, --output-symmetric         Output graph is symmetric [false].\n");
+  fprintf(stderr, "  -p, --profile                  Show time and memory of each phase [false].\n");
+  fprintf(stderr, "  -j, --profile-json <file>      Write time and memory of each phase as JSON.\n");
+  fprintf(stderr, "\n");
+  fprintf(stderr, "Kinds of random graph:\n");
+  fprintf(stderr, "  rmat  Recursive MATrix (Kronecker) graph, with 2^ceil(log2 n) vertices.\n");
+  fprintf(stderr, "  gnm   Erdős–Rényi graph, with m edges drawn uniformly at random.\n");
+  fprintf(stderr, "  gnp   Erdős–Rényi graph, with each edge present with probability p.\n");
+  fprintf(stderr, "  ba    Barabási–Albert graph, with preferential attachment.\n");
+  fprintf(stderr, "\n");
+  helpGraphFormats();
+}
+
+
+/**
+ * Validate the parameters of a random graph.
+ * @param o random graph options
+ * @returns true if the random graph can be generated
+ */
+inline bool isRandomGraph(const OptionsGenerate& o) {
+  if (o.kind!="rmat" && o.kind!="gnm" && o.kind!="gnp" && o.kind!="ba") {
+    fprintf(stderr, "Unknown kind of random graph '%s'\n\n", o.kind.c_str());
+    showUsage("-k, --kind <kind>");
+    return false;
+  }
+  if (o.vertices==0) {
+    fprintf(stderr, "Random graph must have vertices\n\n");
+    showUsage("-n, --vertices <count>");
+    return false;
+  }
+  if (o.probability<0 || o.probability>1 || o.pa<0 || o.pb<0 || o.pc<0 || o.pa+o.pb+o.pc>1) {
+    fprintf(stderr, "Probabilities must be in [0, 1]\n\n");
+    showUsage("-e, --edge-probability <p>  -a, -b, -c <p>");
+    return false;
+  }
+  return true;
+}
+
+
+/**
+ * Parse command line arguments for the generate command.
+ * @param argc argument count
+ * @param argv argument values
+ * @param i start index of arguments [1]
+ * @returns options
+ */
+inline OptionsGenerate parseOptionsGenerate(int argc, char **argv, int i=1) {
+  OptionsGenerate o;
+  // Parse command-line arguments.
+  for (; i<argc; ++i) {
+    string k = argv[i];
+    if (k=="") continue;
+    else if (k=="-h" || k=="--help") o.help = true;
+    else if (k=="-k" || k=="--kind")     o.kind     = argv[++i];
+    else if (k=="-n" || k=="--vertices") o.vertices = strtoull(argv[++i], nullptr, 10);
+    else if (k=="-m" || k=="--edges")    o.edges    = strtoull(argv[++i], nullptr, 10);
+    else if (k=="-e" || k=="--edge-probability") o.probability = atof(argv[++i]);
+    else if (k=="-d" || k=="--degree")   o.degree   = strtoull(argv[++i], nullptr, 10);
+    else if (k=="-a") o.pa = atof(argv[++i]);
+    else if (k=="-b") o.pb = atof(argv[++i]);
+    else if (k=="-c") o.pc = atof(argv[++i]);
+    else if (k=="-r" || k=="--seed")     o.seed     = strtoull(argv[++i], nullptr, 10);
+    else if (k=="-u" || k=="--undirected") o.undirected = true;
+    else if (k=="-o" || k=="--output") o.outputFile = argv[++i];
+    else if (k=="-g" || k=="--output-format") o.outputFormat = argv[++i];
+    else if (k=="-q" || k=="--output-sequential") o.outputSequential = true;
+    else if (k=="-x" || k=="--output-weighted")  o.outputWeighted  = true;
+    else if (k=="-D" || k=="--double-weights")   o.doubleWeights   = true;
+    else if (k=="-t" || k=="--output-symmetric") o.outputSymmetric = true;
+    else if (k=="-p" || k=="--profile") o.profile = true;
+    else if (k=="-j" || k=="--profile-json") o.profileFile = argv[++i];
+    else { fprintf(stderr, "Unknown option '%s'\n\n", k.c_str()); return o; }
+  }
+  // Validate options.
+  if (o.help) return o;
+  if (!isOutputFile(o.outputFile)) return o;
+  if (!isGraphFormat(o.outputFormat, "-g, --output-format <format>")) return o;
+  if (!isRandomGraph(o)) return o;
+  o.valid = true;
+  return o;
+}
+
+
+/**
+ * Parse the specification of a random graph, used as input (see gen format).
+ * @param x specification, as "<kind>[:<key>=<value>,...]", e.g. "rmat:n=1024,m=8192,seed=1"
+ * @returns random graph options (output file and format are unused)
+ * @note Keys are n (vertices), m (edges), p (edge probability), d (degree),
+ * a, b, c (quadrant probabilities), seed, and u (undirected).
+ */
+inline OptionsGenerate parseGenerateSpec(const string& x) {
+  OptionsGenerate o;
+  size_t i = x.find(':');
+  o.kind = x.substr(0, i);
+  // Parse key=value pairs.
+  for (i = i==string::npos? x.size() : i+1; i<x.size();) {
+    size_t j = x.find(',', i);
+    if (j==string::npos) j = x.size();
+    string kv = x.substr(i, j-i);
+    size_t e  = kv.find('=');
+    string k  = kv.substr(0, e);
+    string v  = e==string::npos? "1" : kv.substr(e+1);
+    i = j + 1;
+    if (k=="") continue;
+    else if (k=="n") o.vertices = strtoull(v.c_str(), nullptr, 10);
+    else if (k=="m") o.edges    = strtoull(v.c_str(), nullptr, 10);
+    else if (k=="p") o.probability = atof(v.c_str());
+    else if (k=="d") o.degree   = strtoull(v.c_str(), nullptr, 10);
+    else if (k=="a") o.pa = atof(v.c_str());
+    else if (k=="b") o.pb = atof(v.c_str());
+    else if (k=="c") o.pc = atof(v.c_str());
+    else if (k=="seed") o.seed = strtoull(v.c_str(), nullptr, 10);
+    else if (k=="u") o.undirected = v!="0";
+    else { fprintf(stderr, "Unknown random graph parameter '%s'\n\n", k.c_str()); showUsage("-i, --input <kind>[:n=,m=,p=,d=,a=,b=,c=,seed=,u]"); return o; }
+  }
+  // Validate options.
+  if (!isRandomGraph(o)) return o;
+  o.valid = true;
+  return o;
+}
+#pragma endregion
+
+
+
+
+#pragma region REORDER
+/**
+ * Command-line options for the reorder command.
+ */
+struct OptionsReorder {
+  /** Show help message? */
+  bool help = false;
+  /** Is it valid? */
+  bool valid = false;
+  /** Input file name. */
+  string inputFile = "";
+  /** Input file format (see supported formats). */
+  string inputFormat = "mtx";
+  /** Output file name. */
+  string outputFile = "";
+  /** Output file format (see supported formats). */
+  string outputFormat = "mtx";
+  /** Whether the output file should be written sequentially. */
+  bool outputSequential = false;
+  /** Whether the input graph is weighted. */
+  bool inputWeighted = false;
+  /** Whether the output graph is weighted. */
+  bool outputWeighted = false;
+  /** Whether edge weights are kept in double precision (else single). */
+  bool doubleWeights = false;
+  /** Whether the input graph is symmetric. */
+  bool inputSymmetric = false;
+  /** Whether the output graph is symmetric. */
+  bool outputSymmetric = false;
+  /** Vertex ordering (degree, bfs, cm, rcm, community). */
+  string order = "rcm";
+  /** Community membership file name (for community ordering). */
+  string membershipFile = "";
+  /** Whether the community membership and vertex vector files are keyed. */
+  bool membershipKeyed = false;
+  /** Community membership and vertex vector start index. */
+  int membershipStart = 0;
+  /** Vertex vector files to reorder (written to <file>.reordered). */
+  vector<string> vectorFiles;
+  /** File to write the new id of each vertex to (empty for none). */
+  string permutationFile = "";
+  /** Whether to show the time and memory of each phase. */
+  bool profile = false;
+  /** File to write the time and memory of each phase to (JSON). */
+  string profileFile = "";
+};
+
+
+/**
+ * Show help message for the reorder command.
+ * @param name program name
+ */
+inline void helpReorder(const char *name) {
+  fprintf(stderr, "%s reorder:\n", name);
+  fprintf(stderr, "Renumber the vertices of a graph, to improve the locality of its edges.\n");
+  fprintf(stderr, "\n");
+  fprintf(stderr, "Options:\n");
+  fprintf(stderr, "  -h, --help                    Show this help message.\n");
+  fprintf(stderr, "  -i, --input <file>            Input file name.\n");
+  fprintf(stderr, "  -f, --input-format <format>   Input file format [mtx].\n");
+  fprintf(stderr, "  -o, --output <file>           Output file name.\n");
+  fprintf(stderr, "  -g, --output-format <format>  Output file format [mtx].\n");
+  fprintf(stderr, "  -q, --output-sequential       Write output file sequentially [false].\n");
+  fprintf(stderr, "  -w, --input-weighted          Input graph is weighted [false].\n");
+  fprintf(stderr, "  -x, --output-weighted         Output graph is weighted [false].\n");
+  fprintf(stderr, "  -D, --double-weights          Keep edge weights in double precision [false].\n");
+  fprintf(stderr, "  -s, --input-symmetric         Input graph is symmetric [false].\n");
+  fprintf(stderr, "  -t, --output-symmetric        Output graph is symmetric [false].\n");
+  fprintf(stderr, "  -a, --order <order>           Vertex ordering [rcm].\n");
+  fprintf(stderr, "  -m, --membership <file>       Community membership file name.\n");
+  fprintf(stderr, "  -k, --membership-keyed        Community membership and vector files are keyed.\n");
+  fprintf(stderr, "  -r, --membership-start        Community membership and vector start index.\n");
+  fprintf(stderr, "  -v, --vector <file>           Vertex vector file to reorder, into <file>.reordered.\n");
+  fprintf(stderr, "  -e, --permutation <file>      Write the new id of each vertex (old new).\n");
+  fprintf(stderr, "  -p, --profile                 Show time and memory of each phase [false].\n");
+  fprintf(stderr, "  -j, --profile-json <file>     Write time and memory of each phase as JSON.\n");
+  fprintf(stderr, "\n");
+  fprintf(stderr, "Vertex orderings:\n");
+  fprintf(stderr, "  degree     Decreasing order of degree.\n");
+  fprintf(stderr, "  bfs        Breadth-first order, from the lowest degree vertex of each component.\n");
+  fprintf(stderr, "  cm         Cuthill–McKee, i.e., BFS visiting children in increasing order of degree.\n");
+  fprintf(stderr, "  rcm        Reverse Cuthill–McKee.\n");
+  fprintf(stderr, "  community  Vertices of each community together (needs --membership).\n");
+  fprintf(stderr, "\n");
+  helpGraphFormats();
+}
+
+
+/**
+ * Parse command line arguments for the reorder command.
+ * @param argc argument count
+ * @param argv argument values
+ * @param i start index of arguments [1]
+ * @returns options
+ */
+inline OptionsReorder parseOptionsReorder(int argc, char **argv, int i=1) {
+  OptionsReorder o;
+  // Parse command-line arguments.
+  for (; i<argc; ++i) {
+    string k = argv[i];
+    if (k=="") continue;
+    else if (k=="-h" || k=="--help") o.help = true;
+    else if (k=="-i" || k=="--input")  o.inputFile  = argv[++i];
+    else if (k=="-f" || k=="--input-format")  o.inputFormat  = argv[++i];
+    else if (k=="-o" || k=="--output") o.outputFile = argv[++i];
+    else if (k=="-g" || k=="--output-format") o.outputFormat = argv[++i];
+    else if (k=="-q" || k=="--output-sequential") o.outputSequential = true;
+    else if (k=="-w" || k=="--input-weighted")   o.inputWeighted   = true;
+    else if (k=="-x" || k=="--output-weighted")  o.outputWeighted  = true;
+    else if (k=="-D" || k=="--double-weights")   o.doubleWeights   = true;
+    else if (k=="-s" || k=="--input-symmetric")  o.inputSymmetric  = true;
+    else if (k=="-t" || k=="--output-symmetric") o.outputSymmetric = true;
+    else if (k=="-a" || k=="--order") o.order = argv[++i];
+    else if (k=="-m" || k=="--membership") o.membershipFile  = argv[++i];
+    else if (k=="-k" || k=="--membership-keyed") o.membershipKeyed = true;
+    else if (k=="-r" || k=="--membership-start") o.membershipStart = atoi(argv[++i]);
+    else if (k=="-v" || k=="--vector") o.vectorFiles.push_back(argv[++i]);
+    else if (k=="-e" || k=="--permutation") o.permutationFile = argv[++i];
+    else if (k=="-p" || k=="--profile") o.profile = true;
+    else if (k=="-j" || k=="--profile-json") o.profileFile = argv[++i];
+    else { fprintf(stderr, "Unknown option '%s'\n\n", k.c_str()); return o; }
+  }
+  // Validate options.
+  if (o.help) return o;
+  if (!isInputFile(o.inputFile)) return o;
+  if (!isOutputFile(o.outputFile)) return o;
+  if (!isInputGraphFormat(o.inputFormat)) return o;
+  if (!isGraphFormat(o.outputFormat, "-g, --output-format <format>")) return o;
+  if (o.order!="degree" && o.order!="bfs" && o.order!="cm" && o.order!="rcm" && o.order!="community") {
+    fprintf(stderr, "Unknown vertex ordering '%s'\n\n", o.order.c_str());
+    showUsage("-a, --order <order>");
+    return o;
+  }
+  if (o.order=="community" && !isInputFile(o.membershipFile, "-m, --membership <file>")) return o;
+  for (const auto& file : o.vectorFiles)
+    if (!isInputFile(file, "-v, --vector <file>")) return o;
+  o.valid = true;
+  return o;
+}
+#pragma endregion
+
+
+
+
+#pragma region PIPELINE
+/**
+ * Command-line options for the pipeline command.
+ */
+struct OptionsPipeline {
+  /** Show help message? */
+  bool help = false;
+  /** Is it valid? */
+  bool valid = false;
+  /** Input file name. */
+  string inputFile = "";
+  /** Input file format (see supported formats). */
+  string inputFormat = "mtx";
+  /** Output file names. */
+  vector<string> outputFiles;
+  /** Output file formats, one for each output file (see supported formats). */
+  vector<string> outputFormats;
+  /** Whether the output files should be written sequentially. */
+  bool outputSequential = false;
+  /** Whether the input graph is weighted. */
+  bool inputWeighted = false;
+  /** Whether the output graph is weighted. */
+  bool outputWeighted = false;
+  /** Whether edge weights are kept in double precision (else single). */
+  bool doubleWeights = false;
+  /** Whether the input graph is symmetric. */
+  bool inputSymmetric = false;
+  /** Whether the output graph is symmetric. */
+  bool outputSymmetric = false;
+  /** Transformations to apply, in order (see supported steps). */
+  vector<string> steps;
+  /** Whether to show the time and memory of each phase. */
+  bool profile = false;
+  /** File to write the time and memory of each phase to (JSON). */
+  string profileFile = "";
+};
+
+
+/**
+ * Show help message for the pipeline command.
+ * @param name program name
+ */
+inline void helpPipeline(const char *name) {
+  fprintf(stderr, "%s pipeline:\n", name);
+  fprintf(stderr, "Read a graph once, apply a sequence of transformations, and write it once.\n");
+  fprintf(stderr, "\n");
+  fprintf(stderr, "Options:\n");
+  fprintf(stderr, "  -h, --help                    Show this help message.\n");
+  fprintf(stderr, "  -i, --input <file>            Input file name.\n");
+  fprintf(stderr, "  -f, --input-format <format>   Input file format [mtx].\n");
+  fprintf(stderr, "  -a, --apply <step>            Transformation to apply (repeat for more, in order).\n");
+  fprintf(stderr, "  -o, --output <file>           Output file name (repeat for more outputs).\n");
+  fprintf(stderr, "  -g, --output-format <format>  Output file format, in order of outputs [mtx].\n");
+  fprintf(stderr, "  -q, --output-sequential       Write output files sequentially [false].\n");
+  fprintf(stderr, "  -w, --input-weighted          Input graph and batch updates are weighted [false].\n");
+  fprintf(stderr, "  -x, --output-weighted         Output graph is weighted [false].\n");
+  fprintf(stderr, "  -D, --double-weights          Keep edge weights in double precision [false].\n");
+  fprintf(stderr, "  -s, --input-symmetric         Input graph is symmetric [false].\n");
+  fprintf(stderr, "  -t, --output-symmetric        Output graph is symmetric [false].\n");
+  fprintf(stderr, "  -p, --profile                 Show time and memory of each phase [false].\n");
+  fprintf(stderr, "  -j, --profile-json <file>     Write time and memory of each phase as JSON.\n");
+  fprintf(stderr, "\n");
+  fprintf(stderr, "Supported steps:\n");
+  fprintf(stderr, "  symmetrize         Add the missing reverse edges.\n");
+  fprintf(stderr, "  add-self-loops     Add a self-loop to each vertex.\n");
+  fprintf(stderr, "  remove-self-loops  Remove all self-loops.\n");
+  fprintf(stderr, "  transpose          Reverse the direction of each edge.\n");
+  fprintf(stderr, "  min-weight:<w>     Keep only edges with weight at least w.\n");
+  fprintf(stderr, "  max-weight:<w>     Keep only edges with weight at most w.\n");
+  fprintf(stderr, "  batch:<file>       Apply a batch update, with lines \"- u v\" for\n");
+  fprintf(stderr, "                     deletions and \"+ u v [w]\" for insertions.\n");
+  fprintf(stderr, "\n");
+  helpGraphFormats();
+}
+
+
+/**
+ * Validate a step of the pipeline command.
+ * @param x step, e.g. "symmetrize" or "batch:<file>"
+ * @returns true if the step is valid
+ */
+inline bool isPipelineStep(const string& x) {
+  size_t c = x.find(':');
+  string name = x.substr(0, c);
+  string arg  = c==string::npos? "" : x.substr(c+1);
+  bool   a    = false;
+  if (name=="symmetrize" || name=="add-self-loops" || name=="remove-self-loops" || name=="transpose") a = c==string::npos;
+  else if (name=="min-weight" || name=="max-weight") {
+    char *end = nullptr;
+    strtod(arg.c_str(), &end);
+    a = !arg.empty() && *end=='\0';
+  }
+  else if (name=="batch") a = !arg.empty();
+  if (a) return true;
+  fprintf(stderr, "Unknown pipeline step '%s'\n\n", x.c_str());
+  showUsage("-a, --apply <step>");
+  return false;
+}
+
+
+/**
+ * Parse command line arguments for the pipeline command.
+ * @param argc argument count
+ * @param argv argument values
+ * @param i start index of arguments [1]
+ * @returns options
+ */
+inline OptionsPipeline parseOptionsPipeline(int argc, char **argv, int i=1) {
+  OptionsPipeline o;
+  // Parse command-line arguments.
+  for (; i<argc; ++i) {
+    string k = argv[i];
+    if (k=="") continue;
+    else if (k=="-h" || k=="--help") o.help = true;
+    else if (k=="-i" || k=="--input")  o.inputFile  = argv[++i];
+    else if (k=="-f" || k=="--input-format")  o.inputFormat  = argv[++i];
+    else if (k=="-a" || k=="--apply")  o.steps.push_back(argv[++i]);
+    else if (k=="-o" || k=="--output") o.outputFiles.push_back(argv[++i]);
+    else if (k=="-g" || k=="--output-format") o.outputFormats.push_back(argv[++i]);
+    else if (k=="-q" || k=="--output-sequential") o.outputSequential = true;
+    else if (k=="-w" || k=="--input-weighted")   o.inputWeighted   = true;
+    else if (k=="-x" || k=="--output-weighted")  o.outputWeighted  = true;
+    else if (k=="-D" || k=="--double-weights")   o.doubleWeights   = true;
+    else if (k=="-s" || k=="--input-symmetric")  o.inputSymmetric  = true;
+    else if (k=="-t" || k=="--output-symmetric") o.outputSymmetric = true;
+    else if (k=="-p" || k=="--profile") o.profile = true;
+    else if (k=="-j" || k=="--profile-json") o.profileFile = argv[++i];
+    else { fprintf(stderr, "Unknown option '%s'\n\n", k.c_str()); return o; }
+  }
+  // Validate options.
+  if (o.help) return o;
+  if (!isInputFile(o.inputFile)) return o;
+  if (!isInputGraphFormat(o.inputFormat)) return o;
+  if (o.outputFiles.empty() && !isOutputFile("")) return o;
+  if (o.outputFormats.size() > o.outputFiles.size()) {
+    fprintf(stderr, "More output formats than output files\n\n");
+    showUsage("-g, --output-format <format>");
+    return o;
+  }
+  o.outputFormats.resize(o.outputFiles.size(), "mtx");
+  for (const auto& format : o.outputFormats)
+    if (!isGraphFormat(format, "-g, --output-format <format>")) return o;
+  for (const auto& step : o.steps)
+    if (!isPipelineStep(step)) return o;
+  o.valid = true;
+  return o;
+}
+#pragma endregion
+
+
+
+
+#pragma region BENCHMARK
+/**
+ * Command-line options for the benchmark command.
+ */
+struct OptionsBenchmark {
+  /** Show help message? */
+  bool help = false;
+  /** Is it valid? */
+  bool valid = false;
+  /** Input file name (empty for a random graph). */
+  string inputFile = "";
+  /** Input file format (see supported formats). */
+  string inputFormat = "mtx";
+  /** Output file name, for the writer kernel. */
+  string outputFile = "benchmark.tmp";
+  /** Whether the input graph is weighted. */
+  bool weighted = false;
+  /** Whether the input graph is symmetric. */
+  bool symmetric = false;
+  /** Number of vertices in the random graph. */
+  size_t vertices = 1000000;
+  /** Number of edges in the random graph. */
+  size_t edges = 10000000;
+  /** Numbers of threads to run with (empty for powers of 2, up to the maximum). */
+  string threads = "";
+  /** Number of trials for each kernel. */
+  int repeat = 5;
+  /** File to write the results to (JSON). */
+  string resultFile = "";
+};
+
+
+/**
+ * Show help message for the benchmark command.
+ * @param name program name
+ */
+inline void helpBenchmark(const char *name) {
+  fprintf(stderr, "%s benchmark:\n", name);
+  fprintf(stderr, "Measure the reader, builder, transform, and writer kernels across numbers of threads.\n");
+  fprintf(stderr, "\n");
+  fprintf(stderr, "Options:\n");
+  fprintf(stderr, "  -h, --help                   Show this help message.\n");
+  fprintf(stderr, "  -i, --input <file>           Input file name [random graph].\n");
+  fprintf(stderr, "  -f, --input-format <format>  Input file format (text formats except adj) [mtx].\n");
+  fprintf(stderr, "  -o, --output <file>          Output file name, for the writer [benchmark.tmp].\n");
+  fprintf(stderr, "  -w, --weighted               Input graph is weighted.\n");
+  fprintf(stderr, "  -s, --symmetric              Input graph is symmetric.\n");
+  fprintf(stderr, "  -n, --vertices <count>       Number of vertices in the random graph [1000000].\n");
+  fprintf(stderr, "  -m, --edges <count>          Number of edges in the random graph [10000000].\n");
+  fprintf(stderr, "  -T, --threads <list>         Numbers of threads, e.g. 1,2,4 [powers of 2].\n");
+  fprintf(stderr, "  -r, --repeat <count>         Number of trials for each kernel [5].\n");
+  fprintf(stderr, "  -j, --json <file>            Write the results as JSON.\n");
+  fprintf(stderr, "\n");
+  helpGraphFormats();
+}
+
+
+/**
+ * Parse command line arguments for the benchmark command.
+ * @param argc argument count
+ * @param argv argument values
+ * @param i start index of arguments [1]
+ * @returns options
+ */
+inline OptionsBenchmark parseOptionsBenchmark(int argc, char **argv, int i=1) {
+  OptionsBenchmark o;
+  // Parse command-line arguments.
+  for (; i<argc; ++i) {
+    string k = argv[i];
+    if (k=="") continue;
+    else if (k=="-h" || k=="--help") o.help = true;
+    else if (k=="-i" || k=="--input")  o.inputFile  = argv[++i];
+    else if (k=="-f" || k=="--input-format") o.inputFormat = argv[++i];
+    else if (k=="-o" || k=="--output") o.outputFile = argv[++i];
+    else if (k=="-w" || k=="--weighted")  o.weighted  = true;
+    else if (k=="-s" || k=="--symmetric") o.symmetric = true;
+    else if (k=="-n" || k=="--vertices") o.vertices = strtoull(argv[++i], nullptr, 10);
+    else if (k=="-m" || k=="--edges")    o.edges    = strtoull(argv[++i], nullptr, 10);
+    else if (k=="-T" || k=="--threads")  o.threads  = argv[++i];
+    else if (k=="-r" || k=="--repeat")   o.repeat   = atoi(argv[++i]);
+    else if (k=="-j" || k=="--json")     o.resultFile = argv[++i];
+    else { fprintf(stderr, "Unknown option '%s'\n\n", k.c_str()); return o; }
+  }
+  // Validate options.
+  if (o.help) return o;
+  if (!o.inputFile.empty() && o.inputFormat!="mtx" && o.inputFormat!="coo" && o.inputFormat!="edgelist" && o.inputFormat!="csv" && o.inputFormat!="tsv") {
+    fprintf(stderr, "Graph format '%s' cannot be benchmarked\n\n", o.inputFormat.c_str());
+    showUsage("-f, --input-format <format>");
+    return o;
+  }
+  if (!isOutputFile(o.outputFile)) return o;
+  if (o.inputFile.empty() && (o.vertices==0 || o.edges==0)) {
+    fprintf(stderr, "Random graph must have vertices and edges\n\n");
+    showUsage("-n, --vertices <count>  -m, --edges <count>");
+    return o;
+  }
+  if (o.repeat<1) {
+    fprintf(stderr, "Number of trials must be positive\n\n");
+    showUsage("-r, --repeat <count>");
+    return o;
+  }
+  o.valid = true;
+  return o;
+}
+#pragma endregion
@@ -3,12 +3,15 @@
 #include <vector>
 #include <ostream>
 #include <algorithm>
+#include <type_traits>
 #include "_main.hxx"
 
 using std::pair;
 using std::vector;
 using std::ostream;
 using std::max;
+using std::lower_bound;
+using std::is_same;
 
 
 
@@ -30,6 +33,8 @@ class DiGraph {
   using vertex_value_type = V;
   /** Edge value type (edge weight). */
   using edge_value_type   = E;
+  /** Edge entry type (target vertex id, edge weight). */
+  using edge_entry_type   = typename LazyBitset<K, E>::entry_type;
   #pragma endregion
 
 
@@ -135,6 +140,17 @@ class DiGraph {
   inline void forEachEdgeKey(K u, FP fp) const noexcept {
     edges[u].forEachKey(fp);
   }
+
+  /**
+   * Check if any target vertex id of a source vertex satisfies a test (stops at the first).
+   * @param u source vertex id
+   * @param ft test function (target vertex id)
+   * @returns true if a target vertex id satisfies the test
+   */
+  template <class FT>
+  inline bool anyEdgeKey(K u, FT ft) const noexcept {
+    return edges[u].anyKey(ft);
+  }
   #pragma endregion
 
 
@@ -266,7 +282,7 @@ class DiGraph {
    * @param u source vertex id
    * @param buf scratch buffer for the update
    */
-  inline void updateEdges(K u, vector<pair<K, E>> *buf=nullptr) {
+  inline void updateEdges(K u, vector<edge_entry_type> *buf=nullptr) {
     if (u < span()) edges[u].update(buf);
   }
 
@@ -275,7 +291,7 @@ class DiGraph {
    * @note This is an expensive operation.
    */
   inline void update() {
-    vector<pair<K, E>> buf;
+    vector<edge_entry_type> buf;
     N = 0; M = 0;
     forEachVertexKey([&](K u) {
       edges[u].update(&buf);
@@ -397,6 +413,10 @@ class DiGraphCsr {
 
   #pragma region DATA
   public:
+  /** Number of vertices (cached, see update()). */
+  size_t N = 0;
+  /** Vertex existence flags. */
+  vector<char> exists;
   /** Offsets of the outgoing edges of vertices. */
   vector<O> offsets;
   /** Degree of each vertex. */
@@ -405,7 +425,7 @@ class DiGraphCsr {
   vector<V> values;
   /** Vertex ids of the outgoing edges of each vertex (lookup using offsets). */
   vector<K> edgeKeys;
-  /** Edge weights of the outgoing edges of each vertex (lookup using offsets). */
+  /** Edge weights of the outgoing edges of each vertex (lookup using offsets, empty if E is None). */
   vector<E> edgeValues;
   #pragma endregion
 
@@ -427,7 +447,7 @@ class DiGraphCsr {
    * @returns |V|
    */
   inline size_t order() const noexcept {
-    return degrees.size();
+    return N;
   }
 
   /**
@@ -468,7 +488,7 @@ class DiGraphCsr {
   template <class FP>
   inline void forEachVertex(FP fp) const noexcept {
     for (K u=0; u<span(); ++u)
-      fp(u, values[u]);
+      if (exists[u]) fp(u, values[u]);
   }
 
   /**
@@ -478,7 +498,7 @@ class DiGraphCsr {
   template <class FP>
   inline void forEachVertexKey(FP fp) const noexcept {
     for (K u=0; u<span(); ++u)
-      fp(u);
+      if (exists[u]) fp(u);
   }
 
   /**
@@ -490,8 +510,10 @@ class DiGraphCsr {
   inline void forEachEdge(K u, FP fp) const noexcept {
     size_t i = offsets[u];
     size_t d = degrees[u];
-    for (size_t I=i+d; i<I; ++i)
-      fp(edgeKeys[i], edgeValues[i]);
+    for (size_t I=i+d; i<I; ++i) {
+      if constexpr (is_same<E, None>::value) fp(edgeKeys[i], E());
+      else fp(edgeKeys[i], edgeValues[i]);
+    }
   }
 
   /**
@@ -506,6 +528,21 @@ class DiGraphCsr {
     for (size_t I=i+d; i<I; ++i)
       fp(edgeKeys[i]);
   }
+
+  /**
+   * Check if any target vertex id of a source vertex satisfies a test (stops at the first).
+   * @param u source vertex id
+   * @param ft test function (target vertex id)
+   * @returns true if a target vertex id satisfies the test
+   */
+  template <class FT>
+  inline bool anyEdgeKey(K u, FT ft) const noexcept {
+    size_t i = offsets[u];
+    size_t d = degrees[u];
+    for (size_t I=i+d; i<I; ++i)
+      if (ft(edgeKeys[i])) return true;
+    return false;
+  }
   #pragma endregion
 
 
@@ -537,7 +574,7 @@ class DiGraphCsr {
    * @returns does the vertex exist?
    */
   inline bool hasVertex(K u) const noexcept {
-    return u < span();
+    return u < span() && exists[u];
   }
 
   /**
@@ -588,8 +625,11 @@ class DiGraphCsr {
    * @returns associated weight of the edge
    */
   inline E edgeValue(K u, K v) const noexcept {
-    size_t o = edgeOffset(u, v);
-    return o != size_t(-1)? edgeValues[o] : E();
+    if constexpr (is_same<E, None>::value) return E();
+    else {
+      size_t o = edgeOffset(u, v);
+      return o != size_t(-1)? edgeValues[o] : E();
+    }
   }
 
   /**
@@ -602,7 +642,7 @@ class DiGraphCsr {
   inline bool setEdgeValue(K u, K v, E w) noexcept {
     size_t o = edgeOffset(u, v);
     if (o == size_t(-1)) return false;
-    edgeValues[o] = w;
+    if constexpr (!is_same<E, None>::value) edgeValues[o] = w;
     return true;
   }
   #pragma endregion
@@ -610,11 +650,38 @@ class DiGraphCsr {
 
   #pragma region UPDATE
   public:
+  /**
+   * Remove all vertices and edges from the graph.
+   */
+  inline void clear() noexcept {
+    N = 0;
+    exists.clear();
+    offsets.assign(1, O());
+    degrees.clear();
+    values.clear();
+    edgeKeys.clear();
+    edgeValues.clear();
+  }
+
+
+  /**
+   * Update the number of vertices, after existence flags are changed directly.
+   */
+  inline void update() {
+    N = countValue(exists, char(1));
+  }
+
+
   /**
    * Adjust the order of the graph (or the number of vertices).
    * @param n new order, or number of vertices
+   * @note New vertices are marked as existing.
    */
   inline void resize(size_t n) {
+    size_t S = exists.size();
+    exists.resize(n, 1);
+    if (n>=S) N += n-S;
+    else update();
     offsets.resize(n+1);
     degrees.resize(n);
     values.resize(n);
@@ -625,13 +692,12 @@ class DiGraphCsr {
    * Adjust the order and size of the graph (or the number of vertices and edges).
    * @param n new order, or number of vertices
    * @param m new size, or number of edges
+   * @note New vertices are marked as existing.
    */
   inline void resize(size_t n, size_t m) {
-    offsets.resize(n+1);
-    degrees.resize(n);
-    values.resize(n);
+    resize(n);
     edgeKeys.resize(m);
-    edgeValues.resize(m);
+    if constexpr (!is_same<E, None>::value) edgeValues.resize(m);
   }
 
 
@@ -662,12 +728,242 @@ class DiGraphCsr {
    * @param m number of edges
    */
   DiGraphCsr(size_t n, size_t m) {
+    N = n;
+    exists.resize(n, 1);
     offsets.resize(n+1);
     degrees.resize(n);
     values.resize(n);
     edgeKeys.resize(m);
-    edgeValues.resize(m);
+    if constexpr (!is_same<E, None>::value) edgeValues.resize(m);
+  }
+  #pragma endregion
+};
+
+
+
+/**
+ * A read-only directed graph with CSR representation, that refers to
+ * externally owned arrays (e.g. a memory mapped file), without copying.
+ * @tparam K key type (vertex id)
+ * @tparam V vertex value type (vertex data)
+ * @tparam E edge value type (edge weight)
+ * @tparam O offset type
+ */
+template <class K=uint32_t, class V=None, class E=None, class O=size_t>
+class DiGraphCsrView {
+  #pragma region TYPES
+  public:
+  /** Key type (vertex id). */
+  using key_type = K;
+  /** Vertex value type (vertex data). */
+  using vertex_value_type = V;
+  /** Edge value type (edge weight). */
+  using edge_value_type   = E;
+  /** Offset type (edge offset). */
+  using offset_type       = O;
+  #pragma endregion
+
+
+  #pragma region DATA
+  public:
+  /** Number of vertices. */
+  size_t N = 0;
+  /** Span of vertex ids. */
+  size_t S = 0;
+  /** Vertex existence flags [S] (all vertices exist if null). */
+  const uint8_t *exists = nullptr;
+  /** Offsets of the outgoing edges of vertices [S+1]. */
+  const O *offsets = nullptr;
+  /** Vertex ids of the outgoing edges of each vertex (lookup using offsets). */
+  const K *edgeKeys = nullptr;
+  /** Edge weights of the outgoing edges of each vertex (all 1 if null). */
+  const E *edgeValues = nullptr;
+  /** Memory mapped file holding the arrays. */
+  MappedFile file;
+  #pragma endregion
+
+
+  #pragma region METHODS
+  #pragma region PROPERTIES
+  public:
+  /**
+   * Get the size of buffer required to store data associated with each vertex
+   * in the graph, indexed by its vertex-id.
+   * @returns size of buffer required
+   */
+  inline size_t span() const noexcept {
+    return S;
+  }
+
+  /**
+   * Get the number of vertices in the graph.
+   * @returns |V|
+   */
+  inline size_t order() const noexcept {
+    return N;
   }
+
+  /**
+   * Obtain the number of edges in the graph.
+   * @returns |E|
+   */
+  inline size_t size() const noexcept {
+    return offsets? size_t(offsets[S]) : 0;
+  }
+
+  /**
+   * Check if the graph is empty.
+   * @returns is the graph empty?
+   */
+  inline bool empty() const noexcept {
+    return N == 0;
+  }
+
+  /**
+   * Check if the graph is directed.
+   * @returns is the graph directed?
+   */
+  inline bool directed() const noexcept {
+    return true;
+  }
+  #pragma endregion
+
+
+  #pragma region FOREACH
+  public:
+  /**
+   * Iterate over the vertices in the graph.
+   * @param fp process function (vertex id, vertex data)
+   */
+  template <class FP>
+  inline void forEachVertex(FP fp) const noexcept {
+    for (K u=0; u<span(); ++u)
+      if (hasVertex(u)) fp(u, V());
+  }
+
+  /**
+   * Iterate over the vertex ids in the graph.
+   * @param fp process function (vertex id)
+   */
+  template <class FP>
+  inline void forEachVertexKey(FP fp) const noexcept {
+    for (K u=0; u<span(); ++u)
+      if (hasVertex(u)) fp(u);
+  }
+
+  /**
+   * Iterate over the outgoing edges of a source vertex in the graph.
+   * @param u source vertex id
+   * @param fp process function (target vertex id, edge weight)
+   */
+  template <class FP>
+  inline void forEachEdge(K u, FP fp) const noexcept {
+    size_t i = offsets[u];
+    size_t I = offsets[u+1];
+    for (; i<I; ++i)
+      fp(edgeKeys[i], edgeValues? edgeValues[i] : E(1));
+  }
+
+  /**
+   * Iterate over the target vertex ids of a source vertex in the graph.
+   * @param u source vertex id
+   * @param fp process function (target vertex id)
+   */
+  template <class FP>
+  inline void forEachEdgeKey(K u, FP fp) const noexcept {
+    size_t i = offsets[u];
+    size_t I = offsets[u+1];
+    for (; i<I; ++i)
+      fp(edgeKeys[i]);
+  }
+
+  /**
+   * Check if any target vertex id of a source vertex satisfies a test (stops at the first).
+   * @param u source vertex id
+   * @param ft test function (target vertex id)
+   * @returns true if a target vertex id satisfies the test
+   */
+  template <class FT>
+  inline bool anyEdgeKey(K u, FT ft) const noexcept {
+    size_t i = offsets[u];
+    size_t I = offsets[u+1];
+    for (; i<I; ++i)
+      if (ft(edgeKeys[i])) return true;
+    return false;
+  }
+  #pragma endregion
+
+
+  #pragma region OFFSET
+  public:
+  /**
+   * Get the offset of an edge in the graph.
+   * @param u source vertex id
+   * @param v target vertex id
+   * @returns offset of the edge, or -1 if it does not exist
+   */
+  inline size_t edgeOffset(K u, K v) const noexcept {
+    if (!hasVertex(u) || !hasVertex(v)) return size_t(-1);
+    const K *ib = edgeKeys + offsets[u];
+    const K *ie = edgeKeys + offsets[u+1];
+    const K *it = lower_bound(ib, ie, v);
+    return it!=ie && *it==v? it - edgeKeys : size_t(-1);
+  }
+  #pragma endregion
+
+
+  #pragma region ACCESS
+  public:
+  /**
+   * Check if a vertex exists in the graph.
+   * @param u vertex id
+   * @returns does the vertex exist?
+   */
+  inline bool hasVertex(K u) const noexcept {
+    return u < span() && (!exists || exists[u]);
+  }
+
+  /**
+   * Check if an edge exists in the graph.
+   * @param u source vertex id
+   * @param v target vertex id
+   * @returns does the edge exist?
+   */
+  inline bool hasEdge(K u, K v) const noexcept {
+    size_t o = edgeOffset(u, v);
+    return o != size_t(-1);
+  }
+
+  /**
+   * Get the number of outgoing edges of a vertex in the graph.
+   * @param u vertex id
+   * @returns number of outgoing edges of the vertex
+   */
+  inline size_t degree(K u) const noexcept {
+    return u < span()? size_t(offsets[u+1] - offsets[u]) : 0;
+  }
+
+  /**
+   * Get the vertex data of a vertex in the graph.
+   * @param u vertex id
+   * @returns associated data of the vertex
+   */
+  inline V vertexValue(K u) const noexcept {
+    return V();
+  }
+
+  /**
+   * Get the edge weight of an edge in the graph.
+   * @param u source vertex id
+   * @param v target vertex id
+   * @returns associated weight of the edge
+   */
+  inline E edgeValue(K u, K v) const noexcept {
+    size_t o = edgeOffset(u, v);
+    if (o == size_t(-1)) return E();
+    return edgeValues? edgeValues[o] : E(1);
+  }
+  #pragma endregion
   #pragma endregion
 };
 #pragma endregion
@@ -178,12 +178,12 @@ inline IX set_union_last_inplace(IX xb, IX xe, IY yb, IY ye, IB bb, IB be, FL fl
   // Add elements from `y` into `x`, preferring the last in `y` among matching elements.
   // Both `x` and `y` must be sorted. There must be sufficient space in `x` and `b` (buffer = |y|+2+1).
   if (yb==ye) return xe;
-  if (xb==xe) return unique_last_copy(yb, ye, xb);
+  if (xb==xe) return unique_last_copy(yb, ye, xb, fe);
   // Deque-free loop when there
   // is nothing to insert.
   while (true) {
     while (fl(*xb, *yb))
-      if (++xb==xe) return unique_last_copy(yb, ye, xb);
+      if (++xb==xe) return unique_last_copy(yb, ye, xb, fe);
     if (!fe(*xb, *yb)) break;
     *xb = *yb;
     if (++yb==ye) return xe;
@@ -200,6 +200,8 @@ inline IX set_union_last_inplace(IX xb, IX xe, IY yb, IY ye, IB bb, IB be, FL fl
     if (fe(*it, *yb)) *it = *(yb++);
     else {
       if (xb!=xe) q.push_back(*(xb++));
+      // Drop the element in `x` that matches the one from `y`.
+      if (!q.empty() && fe(q.front(), *yb)) q.pop_front();
       *(++it) = !q.empty() && fl(q.front(), *yb)? q.pop_front() : *(yb++);
     }
   }
@@ -9,12 +9,28 @@
 using std::pair;
 using std::vector;
 using std::sort;
+using std::stable_sort;
 using std::lower_bound;
 
 
 
 
 #pragma region CLASSES
+/**
+ * An entry of a bitset, with a key and a value.
+ * @tparam K key type
+ * @tparam V value type
+ * @note An empty value type, such as None, takes up no space.
+ */
+template <class K, class V>
+struct BitsetEntry {
+  /** The key. */
+  K first;
+  /** The value. */
+  [[no_unique_address]] V second;
+};
+
+
 /**
  * A Lazy bitset is a sparse integer key to value map that updates insertions
  * and deletions upon calling update(). It maintains keys in ascending order.
@@ -30,14 +46,14 @@ class LazyBitset {
   /** The value type. */
   using value_type = V;
   /** The entry type. */
-  using entry_type = pair<K, V>;
+  using entry_type = BitsetEntry<K, V>;
   #pragma endregion
 
 
   #pragma region DATA
   protected:
   /** The pairs of keys and values. */
-  vector<pair<K, V>> pairs;
+  vector<entry_type> pairs;
   /** The number of unprocessed insertions and deletions (-ve). */
   ssize_t unprocessed;
   #pragma endregion
@@ -72,7 +88,7 @@ class LazyBitset {
    * @returns this[i]
    */
   inline pair<K, V> at(size_t i) const noexcept {
-    return pairs[i];
+    return {pairs[i].first, pairs[i].second};
   }
 
   /**
@@ -116,6 +132,18 @@ class LazyBitset {
     for (const auto& p : pairs)
       fp(p.first);
   }
+
+  /**
+   * Check if any key in the bitset satisfies a test (stops at the first).
+   * @param ft test function (key)
+   * @returns true if a key satisfies the test
+   */
+  template <class F>
+  inline bool anyKey(F ft) const noexcept {
+    for (const auto& p : pairs)
+      if (ft(p.first)) return true;
+    return false;
+  }
   #pragma endregion
 
 
@@ -240,9 +268,9 @@ class LazyBitset {
 
   /**
    * Update the bitset by sorting out all unprocessed insertions.
-   * @note This is an expensive operation.
+   * @note This is an expensive operation. The last insertion of a key wins.
    */
-  inline void updateAdd(vector<pair<K, V>> *buf=nullptr) {
+  inline void updateAdd(vector<entry_type> *buf=nullptr) {
     auto  fl = [](const auto& p, const auto& q) { return p.first <  q.first; };
     auto  fe = [](const auto& p, const auto& q) { return p.first == q.first; };
     size_t N = pairs.size();
@@ -255,7 +283,7 @@ class LazyBitset {
     auto ib = pairs.begin();
     auto im = ib + n;
     auto ie = ib + N;
-    sort(im, ie, fl);
+    stable_sort(im, ie, fl);
     auto it = set_union_last_inplace(ib, im, im, ie, bb, be, fl, fe);
     pairs.resize(it - ib);
     unprocessed = 0;
@@ -282,7 +310,7 @@ class LazyBitset {
    * Update the bitset by sorting out all unprocessed insertions and deletions.
    * @note This is an expensive operation.
    */
-  inline void update(vector<pair<K, V>> *buf=nullptr) {
+  inline void update(vector<entry_type> *buf=nullptr) {
     if (unprocessed == 0) return;
     if (unprocessed  < 0) updateRemove();
     else updateAdd(buf);
@@ -294,7 +322,7 @@ class LazyBitset {
    * @param buf buffer for unprocessed insertions
    * @note This operation is lazy.
    */
-  inline void remove(K k, vector<pair<K, V>> *buf=nullptr) {
+  inline void remove(K k, vector<entry_type> *buf=nullptr) {
     if (unprocessed > 0) updateAdd(buf);
     pairs.push_back({k, V()});
     --unprocessed;
@@ -13,6 +13,8 @@
 #include "_queue.hxx"
 #include "_bitset.hxx"
 #include "_iostream.hxx"
+#include "_mman.hxx"
+#include "_profile.hxx"
 #ifdef OPENMP
 #include "_openmp.hxx"
 #endif
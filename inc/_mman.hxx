@@ -0,0 +1,207 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <stdexcept>
+#include <utility>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using std::string;
+using std::string_view;
+using std::runtime_error;
+using std::swap;
+
+
+
+
+#pragma region CLASSES
+/**
+ * A memory mapped file (read-only, or read-write when created with a size).
+ */
+class MappedFile {
+  #pragma region DATA
+  protected:
+  /** File descriptor. */
+  int fd;
+  /** Address of the mapped data. */
+  void *addr;
+  /** Size of the mapped data. */
+  size_t bytes;
+  #pragma endregion
+
+
+  #pragma region METHODS
+  public:
+  /**
+   * Get the address of the mapped data.
+   * @returns pointer to the first byte
+   */
+  inline const char* data() const noexcept {
+    return (const char*) addr;
+  }
+
+  /**
+   * Get the address of the mapped data (for writable mappings).
+   * @returns pointer to the first byte
+   */
+  inline char* data() noexcept {
+    return (char*) addr;
+  }
+
+  /**
+   * Get the size of the mapped data.
+   * @returns number of bytes
+   */
+  inline size_t size() const noexcept {
+    return bytes;
+  }
+
+  /**
+   * Check if nothing is mapped.
+   * @returns is the mapping empty?
+   */
+  inline bool empty() const noexcept {
+    return bytes == 0;
+  }
+
+  /**
+   * Get a view of the mapped data.
+   * @returns string view of the mapped data
+   */
+  inline string_view view() const noexcept {
+    return string_view(data(), bytes);
+  }
+
+  /**
+   * Advise the kernel on the expected access pattern.
+   * @param advice madvise() advice, e.g. MADV_SEQUENTIAL
+   */
+  inline void advise(int advice) const noexcept {
+    if (bytes) madvise(addr, bytes, advice);
+  }
+
+  /**
+   * Unmap the file, and close it.
+   */
+  inline void close() noexcept {
+    if (addr)  munmap(addr, bytes);
+    if (fd>=0) ::close(fd);
+    fd    = -1;
+    addr  = nullptr;
+    bytes = 0;
+  }
+
+  /**
+   * Create a file of given size, and map it to memory (read-write).
+   * @param pth file path (truncated if it exists)
+   * @param size size of the file in bytes
+   * @param advice madvise() advice [MADV_SEQUENTIAL]
+   * @returns writable mapping of the file
+   * @throws runtime_error if file could not be created or mapped
+   * @note This is a named factory, rather than a constructor, so that it
+   * cannot be confused with the read-only MappedFile(pth, advice).
+   */
+  static inline MappedFile create(const char *pth, size_t size, int advice=MADV_SEQUENTIAL) {
+    MappedFile a;
+    a.fd = ::open(pth, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (a.fd<0) throw runtime_error(string("Failed to create file: ") + pth);
+    if (ftruncate(a.fd, off_t(size))<0) throw runtime_error(string("Failed to resize file: ") + pth);
+    if (size==0) return a;
+    void *p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, a.fd, 0);
+    if (p==MAP_FAILED) throw runtime_error(string("Failed to map file: ") + pth);
+    a.addr  = p;
+    a.bytes = size;
+    a.advise(advice);
+    return a;
+  }
+  #pragma endregion
+
+
+  #pragma region CONSTRUCTORS
+  public:
+  /**
+   * Create an empty mapping.
+   */
+  MappedFile() noexcept :
+  fd(-1), addr(nullptr), bytes(0) {}
+
+  /**
+   * Map a file to memory (read-only).
+   * @param pth file path
+   * @param advice madvise() advice [MADV_SEQUENTIAL]
+   * @throws runtime_error if file could not be mapped
+   */
+  MappedFile(const char *pth, int advice=MADV_SEQUENTIAL) :
+  fd(-1), addr(nullptr), bytes(0) {
+    struct stat sb;
+    fd = ::open(pth, O_RDONLY);
+    if (fd<0) throw runtime_error(string("Failed to open file: ") + pth);
+    if (fstat(fd, &sb)<0) { close(); throw runtime_error(string("Failed to stat file: ") + pth); }
+    if (sb.st_size==0) return;
+    void *p = mmap(nullptr, size_t(sb.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p==MAP_FAILED) { close(); throw runtime_error(string("Failed to map file: ") + pth); }
+    addr  = p;
+    bytes = size_t(sb.st_size);
+    advise(advice);
+  }
+
+  /**
+   * Take over the mapping of another file.
+   * @param x another mapped file (cleared)
+   */
+  MappedFile(MappedFile&& x) noexcept :
+  fd(x.fd), addr(x.addr), bytes(x.bytes) {
+    x.fd    = -1;
+    x.addr  = nullptr;
+    x.bytes = 0;
+  }
+
+  /**
+   * Take over the mapping of another file.
+   * @param x another mapped file (swapped)
+   * @returns this
+   */
+  MappedFile& operator=(MappedFile&& x) noexcept {
+    swap(fd,    x.fd);
+    swap(addr,  x.addr);
+    swap(bytes, x.bytes);
+    return *this;
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  /**
+   * Unmap the file, and close it.
+   */
+  ~MappedFile() {
+    close();
+  }
+  #pragma endregion
+};
+#pragma endregion
+
+
+
+
+#pragma region METHODS
+/**
+ * Advise the kernel on the expected access pattern of a range of memory.
+ * @param ptr address of the first byte
+ * @param size number of bytes
+ * @param advice madvise() advice, e.g. MADV_DONTNEED
+ * @returns end of the advised pages, or ptr if none
+ * @note Only the pages that lie entirely within the range are advised.
+ */
+inline const char* adviseMemory(const void *ptr, size_t size, int advice) noexcept {
+  const size_t PAGE = size_t(sysconf(_SC_PAGESIZE));
+  size_t ib = (size_t(ptr) + PAGE-1) / PAGE * PAGE;
+  size_t ie = (size_t(ptr) + size) / PAGE * PAGE;
+  if (ib>=ie) return (const char*) ptr;
+  madvise((void*) ib, ie-ib, advice);
+  return (const char*) ie;
+}
+#pragma endregion
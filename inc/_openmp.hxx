@@ -5,6 +5,20 @@
 
 
 #pragma region BELONGS
+/**
+ * Find the thread that work belongs to.
+ * @param key work key
+ * @param THREADS available threads
+ * @returns thread that work belongs to
+ */
+template <class K>
+inline int ownerOmp(K key, int THREADS) {
+  const K CHUNK_SIZE = 1024;
+  K chunk = key / CHUNK_SIZE;
+  return int(chunk % THREADS);
+}
+
+
 /**
  * Check if work belongs to current thread.
  * @param key work key
@@ -14,9 +28,7 @@
  */
 template <class K>
 inline bool belongsOmp(K key, int thread, int THREADS) {
-  const K CHUNK_SIZE = 1024;
-  K chunk = key / CHUNK_SIZE;
-  return chunk % THREADS == K(thread);
+  return ownerOmp(key, THREADS) == thread;
 }
 
 
@@ -32,3 +44,20 @@ inline bool belongsOmp(K key) {
   return belongsOmp(key, thread, THREADS);
 }
 #pragma endregion
+
+
+
+
+#pragma region ATOMIC
+/**
+ * Atomically replace a value, if it is equal to the expected value.
+ * @param x value to update (updated)
+ * @param expected expected value
+ * @param desired new value
+ * @returns true if value was replaced
+ */
+template <class T>
+inline bool atomicCompareExchange(T& x, T expected, T desired) {
+  return __atomic_compare_exchange_n(&x, &expected, desired, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+#pragma endregion
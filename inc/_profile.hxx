@@ -0,0 +1,227 @@
+#pragma once
+#include <cstdio>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <algorithm>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#include "_utility.hxx"
+#ifdef OPENMP
+#include <omp.h>
+#endif
+
+using std::string;
+using std::vector;
+using std::ostream;
+using std::sort;
+using std::sqrt;
+
+
+
+
+#pragma region METHODS
+#pragma region FILE SIZE
+/**
+ * Get the size of a file.
+ * @param pth file path
+ * @returns size of the file in bytes (0 if it does not exist)
+ */
+inline size_t fileSize(const char *pth) {
+  struct stat sb;
+  if (stat(pth, &sb)<0) return 0;
+  return size_t(sb.st_size);
+}
+#pragma endregion
+
+
+
+
+#pragma region PEAK MEMORY
+/**
+ * Reset the peak resident set size (RSS) of this process, if supported.
+ * @returns true if the peak was reset
+ * @note On Linux, this writes "5" to /proc/self/clear_refs.
+ */
+inline bool resetPeakMemory() {
+  FILE *file = fopen("/proc/self/clear_refs", "w");
+  if (!file) return false;
+  bool done = fputs("5", file)>=0;
+  return fclose(file)==0 && done;
+}
+
+
+/**
+ * Get the peak resident set size (RSS) of this process.
+ * @returns peak RSS in bytes, since start or the last reset
+ */
+inline size_t peakMemory() {
+  // Read the peak from /proc, as it can be reset.
+  FILE *file = fopen("/proc/self/status", "r");
+  if (file) {
+    char line[256];
+    size_t a = 0;
+    while (fgets(line, sizeof(line), file))
+      if (sscanf(line, "VmHWM: %zu kB", &a)==1) break;
+    fclose(file);
+    if (a) return a * 1024;
+  }
+  struct rusage ru;
+  if (getrusage(RUSAGE_SELF, &ru)<0) return 0;
+  return size_t(ru.ru_maxrss) * 1024;
+}
+#pragma endregion
+
+
+
+
+#pragma region STATISTICS
+/**
+ * Find the median of values.
+ * @param x values
+ * @returns median value (0 if empty)
+ */
+template <class T>
+inline double medianValue(vector<T> x) {
+  size_t N = x.size();
+  if (N==0) return 0;
+  sort(x.begin(), x.end());
+  if (N % 2) return double(x[N/2]);
+  return (double(x[N/2-1]) + double(x[N/2])) / 2;
+}
+
+
+/**
+ * Find the (sample) standard deviation of values.
+ * @param x values
+ * @returns standard deviation (0 if less than 2 values)
+ */
+template <class T>
+inline double stddevValue(const vector<T>& x) {
+  size_t N = x.size();
+  if (N<2) return 0;
+  double sum = 0, sqr = 0;
+  for (const T& v : x)
+    sum += double(v);
+  double mean = sum / N;
+  for (const T& v : x)
+    sqr += (double(v) - mean) * (double(v) - mean);
+  return sqrt(sqr / (N-1));
+}
+#pragma endregion
+#pragma endregion
+
+
+
+
+#pragma region CLASSES
+/**
+ * Measurements of a phase of a command.
+ */
+struct ProfilePhase {
+  /** Name of the phase. */
+  string name;
+  /** Wall time in milliseconds. */
+  float duration = 0;
+  /** Number of edges processed. */
+  size_t edges = 0;
+  /** Number of bytes read or written. */
+  size_t bytes = 0;
+  /** Peak resident set size (RSS) during the phase, in bytes. */
+  size_t memory = 0;
+  /** Was the peak reset before the phase? (else, memory is the peak since start) */
+  bool memoryReset = true;
+  /** Number of threads used. */
+  int threads = 1;
+};
+
+
+/**
+ * Per-phase profiler for a command.
+ */
+class Profiler {
+  #pragma region DATA
+  public:
+  /** Measured phases. */
+  vector<ProfilePhase> phases;
+  /** Measure phases? (else, phases are only run) */
+  bool enabled = true;
+  #pragma endregion
+
+
+  #pragma region METHODS
+  public:
+  /**
+   * Run a phase, and measure its wall time and peak memory.
+   * @param name name of the phase
+   * @param fn phase function
+   * @returns measurements of the phase (valid until the next phase)
+   * @note If the peak cannot be reset, the peak since start is recorded, and
+   * the phase is marked as such (see ProfilePhase::memoryReset). If disabled,
+   * the phase is only run, and its peak is neither reset nor read.
+   */
+  template <class F>
+  inline ProfilePhase& measure(const string& name, F fn) {
+    ProfilePhase a;
+    a.name = name;
+    if (!enabled) {
+      fn();
+      phases.push_back(a);
+      return phases.back();
+    }
+    #ifdef OPENMP
+    a.threads = omp_get_max_threads();
+    #endif
+    a.memoryReset = resetPeakMemory();
+    a.duration = measureDuration(fn);
+    a.memory   = peakMemory();
+    phases.push_back(a);
+    return phases.back();
+  }
+
+  /**
+   * Write the measured phases in text format.
+   * @param a output stream
+   */
+  inline void write(ostream& a) const {
+    char buf[512];
+    for (const auto& p : phases) {
+      double s = p.duration / 1000.0;
+      snprintf(buf, sizeof(buf), "> Phase %s: %.3f ms, %.3e edges/s, %.3e bytes/s, peak RSS %.1f MB%s, %d threads\n",
+        p.name.c_str(), p.duration, s>0? p.edges/s : 0.0, s>0? p.bytes/s : 0.0, p.memory / (1024.0*1024.0), p.memoryReset? "" : " (not reset)", p.threads);
+      a << buf;
+    }
+  }
+
+  /**
+   * Write the measured phases in JSON format.
+   * @param a output stream
+   * @param command name of the command
+   */
+  inline void writeJson(ostream& a, const string& command) const {
+    char buf[512];
+    a << "{\n  \"command\": \"" << command << "\",\n  \"phases\": [";
+    for (size_t i=0; i<phases.size(); ++i) {
+      const auto& p = phases[i];
+      double s = p.duration / 1000.0;
+      snprintf(buf, sizeof(buf), "\n    {\"name\": \"%s\", \"duration_ms\": %.3f, \"edges\": %zu, \"bytes\": %zu, \"edges_per_s\": %.6e, \"bytes_per_s\": %.6e, \"peak_rss_bytes\": %zu, \"peak_rss_reset\": %s, \"threads\": %d}",
+        p.name.c_str(), p.duration, p.edges, p.bytes, s>0? p.edges/s : 0.0, s>0? p.bytes/s : 0.0, p.memory, p.memoryReset? "true" : "false", p.threads);
+      a << buf << (i+1<phases.size()? "," : "");
+    }
+    a << "\n  ]\n}\n";
+  }
+  #pragma endregion
+
+
+  #pragma region CONSTRUCTORS
+  public:
+  /**
+   * Create a profiler.
+   * @param enabled measure phases? (else, phases are only run) [true]
+   */
+  Profiler(bool enabled=true) :
+  enabled(enabled) {}
+  #pragma endregion
+};
+#pragma endregion
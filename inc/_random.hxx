@@ -43,3 +43,49 @@ class xorshift32_engine {
 // - https://stackoverflow.com/a/71523041/1413259
 // - https://www.jstatsoft.org/article/download/v008i14/916
 #pragma endregion
+
+
+
+
+#pragma region METHODS
+/**
+ * Mix the bits of a 64-bit value (SplitMix64 finalizer).
+ * @param x value to mix
+ * @returns mixed value
+ */
+inline uint64_t splitmix64Hash(uint64_t x) {
+  x += 0x9E3779B97F4A7C15ULL;
+  x  = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x  = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+
+/**
+ * Generate a counter-based random number.
+ * @param seed random seed
+ * @param i first counter, e.g. edge index
+ * @param j second counter, e.g. draw within the edge [0]
+ * @returns random number, which depends only upon (seed, i, j)
+ * @note As the result does not depend upon any shared state, any thread can
+ * generate the i-th random number, and output is the same for any number of
+ * threads.
+ */
+inline uint64_t counterRandom(uint64_t seed, uint64_t i, uint64_t j=0) {
+  return splitmix64Hash(splitmix64Hash(splitmix64Hash(seed) ^ i) ^ j);
+}
+
+
+/**
+ * Generate a counter-based random real number in [0, 1).
+ * @param seed random seed
+ * @param i first counter, e.g. edge index
+ * @param j second counter, e.g. draw within the edge [0]
+ * @returns random number in [0, 1)
+ */
+inline double counterRandomReal(uint64_t seed, uint64_t i, uint64_t j=0) {
+  return (counterRandom(seed, i, j) >> 11) * 0x1.0p-53;
+}
+// - https://prng.di.unimi.it/splitmix64.c
+// - https://www.thesalmons.org/john/random123/papers/random123sc11.pdf
+#pragma endregion
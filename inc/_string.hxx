@@ -3,15 +3,20 @@
 #include <cmath>
 #include <type_traits>
 #include <utility>
+#include <string>
 #include <string_view>
+#include <charconv>
 #include "_cctype.hxx"
 #include "_exception.hxx"
 
 using std::is_integral;
 using std::is_floating_point;
 using std::pair;
+using std::string;
 using std::string_view;
 using std::pow;
+using std::to_chars;
+using std::chars_format;
 
 
 
@@ -227,6 +232,31 @@ inline I parseNumberW(T& a, I ib, I ie) {
 
 
 
+#pragma region FORMAT NUMBER
+/**
+ * Format a number, and append it to a string.
+ * @param a output string (updated)
+ * @param x number to format (floating-point numbers are formatted as "%f")
+ * @note No temporary strings are created, and once the output string has
+ * grown to its working size, no allocations are made.
+ */
+template <class T>
+inline void formatNumberU(string& a, T x) {
+  char buf[384];  // Enough for "%f" of any double
+  if constexpr (is_floating_point<T>::value) {
+    auto [ie, ec] = to_chars(buf, buf+sizeof(buf), x, chars_format::fixed, 6);
+    a.append(buf, ie);
+  }
+  else if constexpr (is_integral<T>::value) {
+    auto [ie, ec] = to_chars(buf, buf+sizeof(buf), x);
+    a.append(buf, ie);
+  }
+}
+#pragma endregion
+
+
+
+
 #pragma region READ TOKEN
 /**
  * Obtain the next token from a string.
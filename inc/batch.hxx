@@ -231,6 +231,33 @@ inline void applyBatchUpdateU(G& a, const vector<tuple<K, K, V>>& deletions, con
 
 
 #ifdef OPENMP
+/**
+ * Apply a batch update to a graph, without updating it.
+ * @param a input graph (updated, call updateOmpU() to reflect the changes)
+ * @param deletions edge deletions in batch update
+ * @param insertions edge insertions in batch update
+ * @note New vertices are added first. Each thread then applies the deletions,
+ * and then the insertions, of the vertices it owns (see belongsOmp()), in
+ * order. The edges of a vertex are updated when switching from deletions to
+ * insertions, if needed.
+ */
+template <class G, class K, class V>
+inline void applyBatchUpdateLazyOmpU(G& a, const vector<tuple<K, K, V>>& deletions, const vector<tuple<K, K, V>>& insertions) {
+  using E = typename G::edge_value_type;
+  for (auto [u, v, w] : insertions) {
+    a.addVertex(u);
+    a.addVertex(v);
+  }
+  #pragma omp parallel
+  {
+    for (auto [u, v, w] : deletions)
+      removeEdgeOmpU(a, u, v);
+    for (auto [u, v, w] : insertions)
+      addEdgeOmpU(a, u, v, E(w));
+  }
+}
+
+
 /**
  * Apply a batch update to a graph.
  * @param a input graph (updated)
@@ -239,11 +266,7 @@ inline void applyBatchUpdateU(G& a, const vector<tuple<K, K, V>>& deletions, con
  */
 template <class G, class K, class V>
 inline void applyBatchUpdateOmpU(G& a, const vector<tuple<K, K, V>>& deletions, const vector<tuple<K, K, V>>& insertions) {
-  for (auto [u, v, w] : deletions)
-    a.removeEdge(u, v);
-  updateOmpU(a);
-  for (auto [u, v, w] : insertions)
-    a.addEdge(u, v, w);
+  applyBatchUpdateLazyOmpU(a, deletions, insertions);
   updateOmpU(a);
 }
 #endif
@@ -0,0 +1,221 @@
+#pragma once
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <tuple>
+#include <ostream>
+#include "_main.hxx"
+#include "Graph.hxx"
+#include "csr.hxx"
+#include "io.hxx"
+#include "symmetrize.hxx"
+#include "components.hxx"
+#ifdef OPENMP
+#include <omp.h>
+#endif
+
+using std::string;
+using std::string_view;
+using std::vector;
+using std::tuple;
+using std::ostream;
+
+
+
+
+#pragma region CLASSES
+/**
+ * Result of running a benchmark kernel.
+ */
+struct BenchmarkResult {
+  /** Number of threads used. */
+  int threads = 1;
+  /** Name of the kernel. */
+  string kernel;
+  /** Number of trials. */
+  size_t trials = 0;
+  /** Median wall time in milliseconds. */
+  double median = 0;
+  /** Standard deviation of wall time in milliseconds. */
+  double stddev = 0;
+  /** Number of edges processed. */
+  size_t edges = 0;
+  /** Number of bytes read or written. */
+  size_t bytes = 0;
+
+  /**
+   * Get the number of edges processed per second.
+   * @returns edges per second (0 if no time was taken)
+   */
+  inline double edgesPerSecond() const noexcept {
+    return median>0? edges / (median/1000) : 0;
+  }
+
+  /**
+   * Get the number of bytes read or written per second.
+   * @returns bytes per second (0 if no time was taken)
+   */
+  inline double bytesPerSecond() const noexcept {
+    return median>0? bytes / (median/1000) : 0;
+  }
+};
+#pragma endregion
+
+
+
+
+#pragma region METHODS
+#pragma region GENERATE
+/**
+ * Generate a uniform random graph in Edgelist format (1-based vertex ids).
+ * @param n number of vertices
+ * @param m number of edges
+ * @param weighted generate edge weights?
+ * @returns file contents
+ */
+inline string generateRandomEdgelist(size_t n, size_t m, bool weighted) {
+  xorshift32_engine rnd(1);
+  string a;
+  char buf[64];
+  a.reserve(m * (weighted? 24 : 16));
+  for (size_t i=0; i<m; ++i) {
+    size_t u = 1 + rnd() % n;
+    size_t v = 1 + rnd() % n;
+    int    l = weighted? snprintf(buf, sizeof(buf), "%zu %zu %.3f\n", u, v, (rnd() % 1000 + 1) / 1000.0) : snprintf(buf, sizeof(buf), "%zu %zu\n", u, v);
+    a.append(buf, l);
+  }
+  return a;
+}
+#pragma endregion
+
+
+
+
+#pragma region THREADS
+/**
+ * Parse a comma-separated list of thread counts.
+ * @param x list of thread counts (empty for powers of 2, up to the maximum)
+ * @param maxThreads maximum number of threads
+ * @returns thread counts
+ */
+inline vector<int> parseThreads(const string& x, int maxThreads) {
+  vector<int> a;
+  if (x.empty()) {
+    for (int t=1; t<maxThreads; t*=2)
+      a.push_back(t);
+    a.push_back(maxThreads);
+    return a;
+  }
+  for (size_t i=0; i<x.size();) {
+    size_t j = x.find(',', i);
+    if (j==string::npos) j = x.size();
+    int t = atoi(x.substr(i, j-i).c_str());
+    if (t>0) a.push_back(t);
+    i = j + 1;
+  }
+  return a;
+}
+#pragma endregion
+
+
+
+
+#pragma region KERNELS
+#ifdef OPENMP
+/**
+ * Run each benchmark kernel on the body of an Edgelist/COO/MTX file, with each number of threads.
+ * @tparam K type of vertex ids
+ * @tparam E type of edge weights
+ * @param body edges of the graph, in Edgelist format
+ * @param threads numbers of threads to run with
+ * @param repeat number of trials for each kernel
+ * @param outputFile output file name, for the writer kernel (removed after)
+ * @param fr action to perform on the result of each kernel (result)
+ * @param weighted is the graph weighted? [false]
+ * @param symmetric is the graph symmetric? [false]
+ * @note The kernels are: read (parse into per-thread lists), build (CSR),
+ * read-graph (dynamic graph), symmetrize, components (Afforest), and write
+ * (CSR in Edgelist format). The number of threads is left at the last one.
+ */
+template <class K, class E, class FR>
+inline void benchmarkKernelsOmp(string_view body, const vector<int>& threads, int repeat, const string& outputFile, FR fr, bool weighted=false, bool symmetric=false) {
+  for (int T : threads) {
+    omp_set_num_threads(T);
+    vector<float> durations(repeat);
+    auto fk = [&](const char *kernel, size_t edges, size_t bytes) {
+      BenchmarkResult a;
+      a.threads = T;
+      a.kernel  = kernel;
+      a.trials  = durations.size();
+      a.median  = medianValue(durations);
+      a.stddev  = stddevValue(durations);
+      a.edges   = edges;
+      a.bytes   = bytes;
+      fr(a);
+    };
+    // Parse edges into per-thread lists.
+    vector2d<tuple<K, K, E>> edges;
+    for (int r=0; r<repeat; ++r)
+      durations[r] = measureDuration([&]() { readEdgelistFormatListsOmpW(edges, body, weighted); });
+    size_t M = 0;
+    for (const auto& es : edges)
+      M += es.size();
+    fk("read", M, body.size());
+    // Build a CSR graph from the parsed edges.
+    DiGraphCsr<K, None, E> y;
+    for (int r=0; r<repeat; ++r)
+      durations[r] = measureDuration([&]() { csrCreateFromEdgesOmpW(y, edges, 0, symmetric); });
+    fk("build", y.size(), 0);
+    edges.clear();
+    // Read a dynamic graph, with duplicate removal.
+    DiGraph<K, None, E> x0;
+    for (int r=0; r<repeat; ++r)
+      durations[r] = measureDuration([&]() { readGraphEdgelistFormatOmpW(x0, body, weighted, symmetric); });
+    fk("read-graph", x0.size(), body.size());
+    // Symmetrize a copy of the dynamic graph.
+    DiGraph<K, None, E> x;
+    for (int r=0; r<repeat; ++r) {
+      x = x0;
+      durations[r] = measureDuration([&]() { symmetrizeOmpU(x); });
+    }
+    fk("symmetrize", x.size(), 0);
+    x0 = DiGraph<K, None, E>();
+    // Find the connected components of the symmetric graph.
+    for (int r=0; r<repeat; ++r)
+      durations[r] = measureDuration([&]() { componentsAfforestOmp(x); });
+    fk("components", x.size(), 0);
+    // Write the CSR graph in Edgelist format.
+    for (int r=0; r<repeat; ++r)
+      durations[r] = measureDuration([&]() { writeGraphEdgelistFormatOmp(outputFile.c_str(), y, weighted); });
+    fk("write", y.size(), fileSize(outputFile.c_str()));
+    remove(outputFile.c_str());
+  }
+}
+#endif
+#pragma endregion
+
+
+
+
+#pragma region WRITE
+/**
+ * Write benchmark results in JSON format.
+ * @param a output stream
+ * @param input input file name (empty for a random graph)
+ * @param results results of the kernels
+ */
+inline void writeBenchmarkResultsJson(ostream& a, const string& input, const vector<BenchmarkResult>& results) {
+  char buf[512];
+  a << "{\n  \"command\": \"benchmark\",\n  \"input\": \"" << input << "\",\n  \"results\": [";
+  for (size_t i=0; i<results.size(); ++i) {
+    const auto& r = results[i];
+    snprintf(buf, sizeof(buf), "{\"threads\": %d, \"kernel\": \"%s\", \"trials\": %zu, \"median_ms\": %.3f, \"stddev_ms\": %.3f, \"edges\": %zu, \"bytes\": %zu, \"edges_per_s\": %.6e, \"bytes_per_s\": %.6e}",
+      r.threads, r.kernel.c_str(), r.trials, r.median, r.stddev, r.edges, r.bytes, r.edgesPerSecond(), r.bytesPerSecond());
+    a << "\n    " << buf << (i+1<results.size()? "," : "");
+  }
+  a << "\n  ]\n}\n";
+}
+#pragma endregion
+#pragma endregion
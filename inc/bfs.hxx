@@ -1,9 +1,16 @@
 #pragma once
 #include <utility>
 #include <vector>
+#include <algorithm>
+#include "_main.hxx"
+#ifdef OPENMP
+#include <omp.h>
+#endif
 
 using std::vector;
 using std::swap;
+using std::min;
+using std::copy;
 
 
 
@@ -70,4 +77,148 @@ inline vector<FLAG> bfsVisitedForEach(const G& x, K u, FT ft, FP fp) {
   bfsVisitedForEachU(vis, x, u, ft, fp);
   return vis;
 }
+
+
+#ifdef OPENMP
+/**
+ * Find vertices visited with direction-optimizing BFS, using multiple threads.
+ * @param vis vertex visited flags (updated)
+ * @param us start vertices (updated)
+ * @param vs frontier vertices, one per thread (updated)
+ * @param x original graph
+ * @param ft should vertex be visited? (vertex, depth)
+ * @param fp action to perform on every visited vertex (vertex, depth)
+ * @param symmetric is the graph symmetric? (else, only top-down steps) [true]
+ * @note Top-down steps expand the frontier in parallel, marking visited
+ * vertices atomically and collecting the next frontier in per-thread buffers
+ * (small frontiers are expanded by a single thread, to avoid fork-join costs).
+ * When the frontier has many edges compared to the unvisited part of the
+ * graph, steps switch to bottom-up, where each unvisited vertex looks for a
+ * parent in a frontier bitmap, and stop at the first one (Beamer et al.).
+ * Bottom-up steps follow edges backwards, so they are only taken if the graph
+ * is symmetric. Both ft and fp are called concurrently, and ft may be called
+ * more than once for a vertex (it must not have side effects).
+ */
+template <class B, class G, class K, class FT, class FP>
+inline void bfsVisitedForEachOmpU(vector<B>& vis, vector<K>& us, vector2d<K>& vs, const G& x, FT ft, FP fp, bool symmetric=true) {
+  const size_t ALPHA = 14;  // Switch to bottom-up when frontier edges > unvisited edges / ALPHA
+  const size_t BETA  = 24;  // Switch to top-down when frontier vertices < vertices / BETA
+  const size_t SERIAL = 2048;  // Perform top-down steps on smaller frontiers with one thread
+  const int T = omp_get_max_threads();
+  size_t S = x.span();
+  vector<B> front, next;
+  vector<size_t> offsets(T+1);
+  vs.resize(T);
+  // Visit the start vertices.
+  size_t I = 0;
+  for (K u : us) {
+    if (vis[u] || !ft(u, K())) continue;
+    vis[u] = B(1);
+    us[I++] = u;
+    fp(u, K());
+  }
+  us.resize(I);
+  size_t nf = us.size(), mf = 0, mu = x.size();
+  for (K u : us)
+    mf += x.degree(u);
+  bool bottomUp = false;
+  for (K d=1; nf>0; ++d) {
+    size_t nfOld = nf;
+    mu -= min(mu, mf);
+    // Switch to bottom-up, with a frontier bitmap.
+    if (symmetric && !bottomUp && mf > mu/ALPHA) {
+      front.assign(S, B());
+      next .assign(S, B());
+      #pragma omp parallel for schedule(static, 2048)
+      for (size_t i=0; i<us.size(); ++i)
+        front[us[i]] = B(1);
+      bottomUp = true;
+    }
+    // Perform a bottom-up step.
+    if (bottomUp) {
+      nf = 0; mf = 0;
+      #pragma omp parallel for schedule(dynamic, 2048) reduction(+:nf, mf)
+      for (size_t u=0; u<S; ++u) {
+        next[u] = B();
+        if (vis[u] || !x.hasVertex(K(u)) || !ft(K(u), d)) continue;
+        if (!x.anyEdgeKey(K(u), [&](K v) { return bool(front[v]); })) continue;
+        vis[u]  = B(1);
+        next[u] = B(1);
+        fp(K(u), d);
+        ++nf; mf += x.degree(K(u));
+      }
+      swap(front, next);
+      // Switch back to top-down, with a frontier list, when it shrinks.
+      if (nf >= S/BETA || nf >= nfOld) continue;
+      #pragma omp parallel for schedule(static, 2048)
+      for (size_t u=0; u<S; ++u) {
+        if (!front[u]) continue;
+        int t = omp_get_thread_num();
+        vs[t].push_back(K(u));
+      }
+      bottomUp = false;
+    }
+    // Perform a top-down step.
+    else {
+      #pragma omp parallel for schedule(dynamic, 64) if (us.size() >= SERIAL)
+      for (size_t i=0; i<us.size(); ++i) {
+        int t = omp_get_thread_num();
+        x.forEachEdgeKey(us[i], [&](K v) {
+          if (vis[v] || !ft(v, d)) return;
+          if (!atomicCompareExchange(vis[v], B(), B(1))) return;
+          vs[t].push_back(v);
+          fp(v, d);
+        });
+      }
+    }
+    // Gather the per-thread buffers into the next frontier.
+    for (int t=0; t<T; ++t)
+      offsets[t+1] = offsets[t] + vs[t].size();
+    us.resize(offsets[T]);
+    #pragma omp parallel for schedule(static, 1) if (us.size() >= SERIAL)
+    for (int t=0; t<T; ++t) {
+      copy(vs[t].begin(), vs[t].end(), us.begin() + offsets[t]);
+      vs[t].clear();
+    }
+    nf = us.size(); mf = 0;
+    #pragma omp parallel for schedule(static, 2048) reduction(+:mf) if (us.size() >= SERIAL)
+    for (size_t i=0; i<us.size(); ++i)
+      mf += x.degree(us[i]);
+  }
+  us.clear();
+}
+
+
+/**
+ * Find vertices visited with direction-optimizing BFS, using multiple threads.
+ * @param vis vertex visited flags (updated)
+ * @param x original graph (symmetric)
+ * @param u start vertex
+ * @param ft should vertex be visited? (vertex, depth)
+ * @param fp action to perform on every visited vertex (vertex, depth)
+ */
+template <class B, class G, class K, class FT, class FP>
+inline void bfsVisitedForEachOmpU(vector<B>& vis, const G& x, K u, FT ft, FP fp) {
+  vector<K>   us {u};
+  vector2d<K> vs;
+  bfsVisitedForEachOmpU(vis, us, vs, x, ft, fp);
+}
+
+
+/**
+ * Find vertices visited with direction-optimizing BFS, using multiple threads.
+ * @tparam FLAG visited flag type
+ * @param x original graph (symmetric)
+ * @param u start vertex
+ * @param ft should vertex be visited? (vertex, depth)
+ * @param fp action to perform on every visited vertex (vertex, depth)
+ * @returns vertex visited flags
+ */
+template <class FLAG=char, class G, class K, class FT, class FP>
+inline vector<FLAG> bfsVisitedForEachOmp(const G& x, K u, FT ft, FP fp) {
+  vector<FLAG> vis(x.span());
+  bfsVisitedForEachOmpU(vis, x, u, ft, fp);
+  return vis;
+}
+#endif
 #pragma endregion
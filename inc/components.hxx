@@ -0,0 +1,171 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include "_main.hxx"
+#ifdef OPENMP
+#include <omp.h>
+#endif
+
+using std::vector;
+using std::unordered_map;
+using std::min;
+using std::max;
+using std::sort;
+
+
+
+
+#pragma region METHODS
+#pragma region COMPONENTS
+#ifdef OPENMP
+/**
+ * Link two vertices into the same component, pointing the higher root to the lower.
+ * @param comp component (parent) of each vertex (updated)
+ * @param u first vertex
+ * @param v second vertex
+ */
+template <class K>
+inline void componentsLinkOmpU(vector<K>& comp, K u, K v) {
+  K p1 = comp[u];
+  K p2 = comp[v];
+  while (p1 != p2) {
+    K high = max(p1, p2);
+    K low  = min(p1, p2);
+    K ph   = comp[high];
+    if (ph == low) break;
+    if (ph == high && atomicCompareExchange(comp[high], high, low)) break;
+    p1 = comp[comp[high]];
+    p2 = comp[low];
+  }
+}
+
+
+/**
+ * Point each vertex directly to the root of its component.
+ * @param comp component (parent) of each vertex (updated)
+ */
+template <class K>
+inline void componentsCompressOmpU(vector<K>& comp) {
+  size_t S = comp.size();
+  #pragma omp parallel for schedule(static, 2048)
+  for (size_t u=0; u<S; ++u) {
+    while (comp[u] != comp[comp[u]])
+      comp[u] = comp[comp[u]];
+  }
+}
+#endif
+
+
+/**
+ * Find the most frequent component, from a sample of vertices.
+ * @param x original graph
+ * @param comp component of each vertex
+ * @param samples number of vertices to sample [1024]
+ * @returns most frequent component in the sample
+ */
+template <class G, class K>
+inline K componentsSampleFrequent(const G& x, const vector<K>& comp, size_t samples=1024) {
+  xorshift32_engine rnd(1);
+  unordered_map<K, size_t> counts;
+  size_t S = x.span();
+  if (S==0) return K();
+  for (size_t i=0; i<samples; ++i) {
+    K u = K(rnd() % S);
+    if (x.hasVertex(u)) ++counts[comp[u]];
+  }
+  K a = K(); size_t n = 0;
+  for (auto [c, m] : counts)
+    if (m>n || (m==n && c<a)) { a = c; n = m; }
+  return a;
+}
+
+
+#ifdef OPENMP
+/**
+ * Find the connected components of a graph, using Afforest.
+ * @param x original graph (symmetric)
+ * @param fe should edge be followed? (u, v)
+ * @returns component of each vertex (its smallest vertex id)
+ * @note Each vertex first links with its first few neighbors, which usually
+ * finds the largest component. The remaining edges are then only followed
+ * from vertices outside the largest component, which skips most edges of
+ * real-world graphs (Sutton et al.). As edges are only followed one way in
+ * this last step, the graph (and the edge filter) must be symmetric.
+ */
+template <class G, class FE>
+inline auto componentsAfforestOmp(const G& x, FE fe) {
+  using  K = typename G::key_type;
+  const  K ROUNDS = 2;
+  size_t S = x.span();
+  vector<K> comp(S);
+  #pragma omp parallel for schedule(static, 2048)
+  for (size_t u=0; u<S; ++u)
+    comp[u] = K(u);
+  // Link each vertex with its r-th neighbor.
+  for (K r=0; r<ROUNDS; ++r) {
+    #pragma omp parallel for schedule(dynamic, 2048)
+    for (size_t u=0; u<S; ++u) {
+      if (!x.hasVertex(K(u))) continue;
+      K i = K();
+      x.anyEdgeKey(K(u), [&](K v) {
+        if (!fe(K(u), v) || i++ < r) return false;
+        componentsLinkOmpU(comp, K(u), v);
+        return true;
+      });
+    }
+    componentsCompressOmpU(comp);
+  }
+  // Link the remaining neighbors, for vertices outside the largest component.
+  K c = componentsSampleFrequent(x, comp);
+  #pragma omp parallel for schedule(dynamic, 2048)
+  for (size_t u=0; u<S; ++u) {
+    if (!x.hasVertex(K(u)) || comp[u]==c) continue;
+    K i = K();
+    x.forEachEdgeKey(K(u), [&](K v) {
+      if (!fe(K(u), v) || i++ < ROUNDS) return;
+      componentsLinkOmpU(comp, K(u), v);
+    });
+  }
+  componentsCompressOmpU(comp);
+  return comp;
+}
+
+
+/**
+ * Find the connected components of a graph, using Afforest.
+ * @param x original graph (symmetric)
+ * @returns component of each vertex (its smallest vertex id)
+ */
+template <class G>
+inline auto componentsAfforestOmp(const G& x) {
+  auto fe = [](auto u, auto v) { return true; };
+  return componentsAfforestOmp(x, fe);
+}
+
+
+/**
+ * Obtain the size of each component.
+ * @param x original graph
+ * @param comp component of each vertex
+ * @returns sizes of components, largest first
+ */
+template <class G, class K>
+inline vector<size_t> componentSizesOmp(const G& x, const vector<K>& comp) {
+  size_t S = x.span();
+  vector<size_t> sizes(S), a;
+  #pragma omp parallel for schedule(static, 2048)
+  for (size_t u=0; u<S; ++u) {
+    if (!x.hasVertex(K(u))) continue;
+    #pragma omp atomic
+    ++sizes[comp[u]];
+  }
+  for (size_t c=0; c<S; ++c)
+    if (sizes[c]) a.push_back(sizes[c]);
+  sort(a.begin(), a.end(), [](size_t p, size_t q) { return p > q; });
+  return a;
+}
+#endif
+#pragma endregion
+#pragma endregion
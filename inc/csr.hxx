@@ -1,10 +1,24 @@
 #pragma once
+#include <utility>
+#include <tuple>
 #include <vector>
 #include <unordered_map>
+#include <algorithm>
+#include <type_traits>
 #include "_main.hxx"
+#ifdef OPENMP
+#include <omp.h>
+#endif
 
+using std::pair;
+using std::tuple;
 using std::vector;
 using std::unordered_map;
+using std::sort;
+using std::unique;
+using std::get;
+using std::is_same;
+using std::max;
 
 
 
@@ -258,6 +272,7 @@ template <class G, class E>
 inline void csrCreateEdgeValuesW(vector<E>& edgeValues, const G& x) {
   size_t M = x.size();
   edgeValues.clear();
+  if constexpr (is_same<E, None>::value) return;
   edgeValues.reserve(M);
   x.forEachVertexKey([&](auto u) {
     x.forEachEdge(u, [&](auto v, auto w) {
@@ -279,6 +294,7 @@ inline void csrCreateEdgeValuesW(vector<E>& edgeValues, const G& x, const vector
   for (auto u : ks)
     M += x.degree(u);
   edgeValues.clear();
+  if constexpr (is_same<E, None>::value) return;
   edgeValues.reserve(M);
   for (auto u : ks) {
     x.forEachEdge(u, [&](auto v, auto w) {
@@ -390,8 +406,8 @@ template <class O, class K, class E>
 inline void csrAddEdgeU(vector<K>& degrees, vector<K>& edgeKeys, vector<E>& edgeValues, const vector<O>& offsets, K u, K v, E w) {
   O n = degrees[u]++;
   O i = offsets[u] + n;
-  edgeKeys[i]   = v;
-  edgeValues[i] = w;
+  edgeKeys[i] = v;
+  if constexpr (!is_same<E, None>::value) edgeValues[i] = w;
 }
 
 #ifdef OPENMP
@@ -412,8 +428,174 @@ inline void csrAddEdgeOmpU(vector<K>& degrees, vector<K>& edgeKeys, vector<E>& e
   #pragma omp atomic capture
   { n = degrees[u]; ++degrees[u]; }
   O i = offsets[u] + n;
-  edgeKeys[i]   = v;
-  edgeValues[i] = w;
+  edgeKeys[i] = v;
+  if constexpr (!is_same<E, None>::value) edgeValues[i] = w;
+}
+#endif
+#pragma endregion
+
+
+
+
+#pragma region BUILD
+#ifdef OPENMP
+/**
+ * Sort the outgoing edges of each vertex, and remove duplicate edges, in parallel.
+ * @param degrees degree of each vertex (updated)
+ * @param edgeKeys vertex ids of the outgoing edges of each vertex (updated)
+ * @param edgeValues edge values of the outgoing edges of each vertex (updated, empty if None)
+ * @param offsets offsets of the outgoing edges of vertices
+ * @param seqs input sequence number of each edge [empty => position]
+ * @returns were there duplicate edges with different values?
+ * @note Of duplicate edges, the one with the largest sequence number (the last
+ * one in the input) is kept. Space freed by removed duplicates is left unused
+ * at the end of each vertex's edges. Without edge values, the edges are sorted
+ * in place, as all duplicates are identical.
+ */
+template <class O, class K, class E>
+inline bool csrSortEdgesOmpU(vector<K>& degrees, vector<K>& edgeKeys, vector<E>& edgeValues, const vector<O>& offsets, const vector<O>& seqs) {
+  auto fl = [](const auto& p, const auto& q) {
+    return get<0>(p) < get<0>(q) || (get<0>(p) == get<0>(q) && get<1>(p) < get<1>(q));
+  };
+  auto fe = [](const auto& p, const auto& q) { return get<0>(p) == get<0>(q); };
+  size_t S = degrees.size();
+  bool conflict = false;
+  #pragma omp parallel reduction(||:conflict)
+  {
+    vector<tuple<K, O, E>> buf;
+    #pragma omp for schedule(dynamic, 2048)
+    for (size_t u=0; u<S; ++u) {
+      O i = offsets[u];
+      O I = offsets[u] + degrees[u];
+      // Skip vertices whose edges are already sorted and unique.
+      O j = i + 1;
+      for (; j<I; ++j)
+        if (edgeKeys[j-1] >= edgeKeys[j]) break;
+      if (j>=I) continue;
+      if constexpr (is_same<E, None>::value) {
+        auto ib = edgeKeys.begin() + i;
+        sort(ib, edgeKeys.begin() + I);
+        degrees[u] = K(unique(ib, edgeKeys.begin() + I) - ib);
+      }
+      else {
+        buf.clear();
+        for (O k=i; k<I; ++k)
+          buf.emplace_back(edgeKeys[k], seqs.empty()? k : seqs[k], edgeValues[k]);
+        sort(buf.begin(), buf.end(), fl);
+        for (size_t k=1; k<buf.size(); ++k)
+          if (fe(buf[k-1], buf[k]) && get<2>(buf[k-1]) != get<2>(buf[k])) conflict = true;
+        auto it = unique_last_copy(buf.begin(), buf.end(), buf.begin(), fe);
+        degrees[u] = K(it - buf.begin());
+        for (auto jt=buf.begin(); jt!=it; ++jt, ++i) {
+          edgeKeys[i]   = get<0>(*jt);
+          edgeValues[i] = get<2>(*jt);
+        }
+      }
+    }
+  }
+  return conflict;
+}
+
+
+/**
+ * Sort the outgoing edges of each vertex, and remove duplicate edges, in parallel.
+ * @param degrees degree of each vertex (updated)
+ * @param edgeKeys vertex ids of the outgoing edges of each vertex (updated)
+ * @param edgeValues edge values of the outgoing edges of each vertex (updated, empty if None)
+ * @param offsets offsets of the outgoing edges of vertices
+ * @returns were there duplicate edges with different values?
+ * @note Of duplicate edges, the one stored last is kept.
+ */
+template <class O, class K, class E>
+inline bool csrSortEdgesOmpU(vector<K>& degrees, vector<K>& edgeKeys, vector<E>& edgeValues, const vector<O>& offsets) {
+  return csrSortEdgesOmpU(degrees, edgeKeys, edgeValues, offsets, vector<O>());
+}
+
+
+/**
+ * Create a CSR graph from lists of edges, in parallel.
+ * @param a output csr graph (output)
+ * @param edges lists of edges (u, v, w), in input order when concatenated
+ * @param span minimum number of vertices
+ * @param symmetric add reverse edges too? [false]
+ * @param dense mark all vertices in [1, span) as existing? [false]
+ * @note Degrees are counted, offsets obtained with a prefix sum, and edges
+ * scattered with per-vertex atomic cursors. Each vertex's edges are then
+ * sorted and deduplicated. Only if duplicate edges have different values are
+ * the edges scattered again, with their input sequence numbers, so that the
+ * last of them in input order is kept (as with DiGraph). Unless dense, only
+ * endpoints of edges are marked as existing.
+ */
+template <class G, class K, class E>
+inline void csrCreateFromEdgesOmpW(G& a, const vector2d<tuple<K, K, E>>& edges, size_t span, bool symmetric=false, bool dense=false) {
+  using O = typename G::offset_type;
+  int    T = edges.size();
+  size_t S = span;
+  // Find the span of the graph, and the sequence number of each list's first edge.
+  vector<O> starts(T+1);
+  for (int t=0; t<T; ++t)
+    starts[t+1] = starts[t] + O(edges[t].size());
+  #pragma omp parallel for schedule(static, 1) reduction(max:S)
+  for (int t=0; t<T; ++t) {
+    for (const auto& [u, v, w] : edges[t])
+      S = max(S, size_t(max(u, v)) + 1);
+  }
+  a.clear();
+  a.resize(S);
+  fillValueOmpU(a.exists, char());
+  if (dense && span>1) fillValueOmpU(a.exists.data()+1, span-1, char(1));
+  // Count the degree of each vertex, and mark endpoints as existing.
+  #pragma omp parallel for schedule(static, 1)
+  for (int t=0; t<T; ++t) {
+    for (const auto& [u, v, w] : edges[t]) {
+      #pragma omp atomic write
+      a.exists[u] = 1;
+      #pragma omp atomic write
+      a.exists[v] = 1;
+      #pragma omp atomic
+      ++a.degrees[u];
+      if (!symmetric) continue;
+      #pragma omp atomic
+      ++a.degrees[v];
+    }
+  }
+  a.N = countValueOmp(a.exists, char(1));
+  // Obtain the offsets, and allocate space for the edges.
+  vector<O> buf(omp_get_max_threads());
+  O M = exclusiveScanOmpW(a.offsets.data(), buf.data(), a.degrees.data(), S);
+  a.offsets[S] = M;
+  a.edgeKeys.resize(M);
+  if constexpr (!is_same<E, None>::value) a.edgeValues.resize(M);
+  vector<O> seqs;
+  // Scatter the edges, using the degrees as cursors (and record sequence numbers, if needed).
+  auto fs = [&]() {
+    fillValueOmpU(a.degrees, K());
+    auto fa = [&](K u, K v, E w, O q) {
+      O n = 0;
+      #pragma omp atomic capture
+      { n = a.degrees[u]; ++a.degrees[u]; }
+      O i = a.offsets[u] + n;
+      a.edgeKeys[i] = v;
+      if constexpr (!is_same<E, None>::value) a.edgeValues[i] = w;
+      if (!seqs.empty()) seqs[i] = q;
+    };
+    #pragma omp parallel for schedule(static, 1)
+    for (int t=0; t<T; ++t) {
+      O q = starts[t];
+      for (const auto& [u, v, w] : edges[t]) {
+        fa(u, v, w, q);
+        if (symmetric) fa(v, u, w, q);
+        ++q;
+      }
+    }
+  };
+  // Sort, and deduplicate the edges of each vertex.
+  fs();
+  if (!csrSortEdgesOmpU(a.degrees, a.edgeKeys, a.edgeValues, a.offsets)) return;
+  // Duplicate edges differ in value, so keep the last of them in input order.
+  seqs.resize(M);
+  fs();
+  csrSortEdgesOmpU(a.degrees, a.edgeKeys, a.edgeValues, a.offsets, seqs);
 }
 #endif
 #pragma endregion
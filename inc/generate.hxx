@@ -0,0 +1,217 @@
+#pragma once
+#include <cstdint>
+#include <cmath>
+#include <tuple>
+#include <vector>
+#include <utility>
+#include "_main.hxx"
+#include "csr.hxx"
+#ifdef OPENMP
+#include <omp.h>
+#endif
+
+using std::tuple;
+using std::vector;
+using std::pair;
+using std::min;
+using std::max;
+using std::log;
+using std::floor;
+
+
+
+
+#pragma region METHODS
+#pragma region GENERATE EDGE WEIGHT
+/**
+ * Generate the weight of an edge, from a counter-based random number.
+ * @param seed random seed
+ * @param u source vertex
+ * @param v target vertex
+ * @param weighted generate a random weight? (else 1)
+ * @returns edge weight in (0, 1], same for (u, v) and (v, u)
+ */
+template <class E>
+inline E generateEdgeWeight(uint64_t seed, size_t u, size_t v, bool weighted) {
+  if (!weighted) return E(1);
+  return E(1 - counterRandomReal(~seed, min(u, v), max(u, v)));
+}
+#pragma endregion
+
+
+
+
+#pragma region GENERATE EDGES
+#ifdef OPENMP
+/**
+ * Generate edges in parallel, where each edge depends only upon its index.
+ * @param a lists of edges (u, v, w), one per thread (output)
+ * @param M number of edges
+ * @param seed random seed
+ * @param weighted generate random weights?
+ * @param fe edge function (i) => (u, v)
+ */
+template <class K, class E, class FE>
+inline void generateEdgesOmpW(vector2d<tuple<K, K, E>>& a, size_t M, uint64_t seed, bool weighted, FE fe) {
+  const int T = omp_get_max_threads();
+  a.clear();
+  a.resize(T);
+  #pragma omp parallel for schedule(static, 1)
+  for (int t=0; t<T; ++t) {
+    size_t ib = M / T * t + min(M % T, size_t(t));
+    size_t ie = ib + M / T + (size_t(t) < M % T);
+    a[t].reserve(ie - ib);
+    for (size_t i=ib; i<ie; ++i) {
+      auto [u, v] = fe(i);
+      a[t].emplace_back(K(u), K(v), generateEdgeWeight<E>(seed, u, v, weighted));
+    }
+  }
+}
+
+
+/**
+ * Generate a Recursive MATrix (R-MAT) graph, a kind of Kronecker graph.
+ * @param a lists of edges (u, v, w), one per thread (output)
+ * @param scale number of vertices is 2^scale (1-based vertex ids)
+ * @param M number of edges to generate (with duplicates)
+ * @param pa probability of picking the top-left quadrant [0.57]
+ * @param pb probability of picking the top-right quadrant [0.19]
+ * @param pc probability of picking the bottom-left quadrant [0.19]
+ * @param seed random seed [0]
+ * @param weighted generate random weights? [false]
+ * @note Each edge picks a quadrant of the adjacency matrix, one level at a
+ * time, with the remaining probability going to the bottom-right quadrant.
+ */
+template <class K, class E>
+inline void generateRmatOmpW(vector2d<tuple<K, K, E>>& a, int scale, size_t M, double pa=0.57, double pb=0.19, double pc=0.19, uint64_t seed=0, bool weighted=false) {
+  // Each random number is split into three 21-bit draws, one per level.
+  const int      BITS = 21;
+  const uint64_t MASK = (uint64_t(1) << BITS) - 1;
+  const uint64_t ta = uint64_t(pa * (MASK+1));
+  const uint64_t tb = uint64_t((pa + pb) * (MASK+1));
+  const uint64_t tc = uint64_t((pa + pb + pc) * (MASK+1));
+  auto fe = [&](size_t i) {
+    size_t   u = 0, v = 0;
+    uint64_t h = counterRandom(seed, i), r = 0;
+    for (int l=0; l<scale; ++l) {
+      if (l % 3 == 0) r = splitmix64Hash(h + l);
+      uint64_t x = r & MASK; r >>= BITS;
+      u = (u << 1) | (x >= tb);
+      v = (v << 1) | ((x >= ta) & (x < tb)) | (x >= tc);
+    }
+    return pair<size_t, size_t>(u + 1, v + 1);
+  };
+  generateEdgesOmpW(a, M, seed, weighted, fe);
+}
+// - https://doi.org/10.1137/1.9781611972740.43
+
+
+/**
+ * Generate an Erdős–Rényi G(n, m) graph.
+ * @param a lists of edges (u, v, w), one per thread (output)
+ * @param N number of vertices (1-based vertex ids)
+ * @param M number of edges to generate (with duplicates)
+ * @param seed random seed [0]
+ * @param weighted generate random weights? [false]
+ * @note Edges are drawn with replacement, so duplicate edges, which are
+ * removed when building a graph, leave slightly fewer than M edges.
+ */
+template <class K, class E>
+inline void generateErdosRenyiGnmOmpW(vector2d<tuple<K, K, E>>& a, size_t N, size_t M, uint64_t seed=0, bool weighted=false) {
+  auto fe = [&](size_t i) {
+    size_t u = counterRandom(seed, i, 0) % N;
+    size_t v = counterRandom(seed, i, 1) % N;
+    return pair<size_t, size_t>(u + 1, v + 1);
+  };
+  generateEdgesOmpW(a, M, seed, weighted, fe);
+}
+
+
+/**
+ * Generate an Erdős–Rényi G(n, p) graph, without self-loops.
+ * @param a lists of edges (u, v, w), one per thread (output)
+ * @param N number of vertices (1-based vertex ids)
+ * @param p probability of each edge
+ * @param seed random seed [0]
+ * @param weighted generate random weights? [false]
+ * @note Each vertex skips over its non-edges with geometrically distributed
+ * jumps, drawn from its own random stream, which takes O(N + M) time.
+ */
+template <class K, class E>
+inline void generateErdosRenyiGnpOmpW(vector2d<tuple<K, K, E>>& a, size_t N, double p, uint64_t seed=0, bool weighted=false) {
+  const int T = omp_get_max_threads();
+  a.clear();
+  a.resize(T);
+  if (p<=0) return;
+  double lq = log(1 - p);
+  #pragma omp parallel for schedule(dynamic, 256)
+  for (size_t u=0; u<N; ++u) {
+    int t = omp_get_thread_num();
+    size_t k = 0;
+    for (size_t v=0;; ++v) {
+      // Skip over non-edges, unless all edges are present.
+      if (p<1) {
+        double s = floor(log(1 - counterRandomReal(seed, u, k++)) / lq);
+        if (s >= double(N - v)) break;
+        v += size_t(s);
+      }
+      if (v>=N) break;
+      if (v==u) continue;
+      a[t].emplace_back(K(u+1), K(v+1), generateEdgeWeight<E>(seed, u+1, v+1, weighted));
+    }
+  }
+}
+// - https://doi.org/10.1103/PhysRevE.71.036113
+
+
+/**
+ * Generate a Barabási–Albert graph, with preferential attachment.
+ * @param a lists of edges (u, v, w), one per thread (output)
+ * @param N number of vertices (1-based vertex ids)
+ * @param D number of edges added by each vertex
+ * @param seed random seed [0]
+ * @param weighted generate random weights? [false]
+ * @note Edge i goes from vertex i/D to the endpoint at a random position of
+ * the list of endpoints of edges before it (including its own source), which
+ * picks each vertex in proportion to its degree. A target position only
+ * needs the random numbers of earlier edges, so each edge can be generated
+ * independently (Sanders and Schulz). The first vertex has a self-loop.
+ */
+template <class K, class E>
+inline void generateBarabasiAlbertOmpW(vector2d<tuple<K, K, E>>& a, size_t N, size_t D, uint64_t seed=0, bool weighted=false) {
+  auto fe = [&](size_t i) {
+    // Endpoint 2j is the source of edge j, and endpoint 2j+1 is its target.
+    size_t j = i, v = 0;
+    while (true) {
+      size_t r = counterRandom(seed, j) % (2*j + 1);
+      if (r % 2 == 0) { v = r/2 / D; break; }
+      j = r/2;
+    }
+    return pair<size_t, size_t>(i/D + 1, v + 1);
+  };
+  generateEdgesOmpW(a, N*D, seed, weighted, fe);
+}
+// - https://doi.org/10.1126/science.286.5439.509
+// - https://doi.org/10.1109/IPDPS.2016.30
+#endif
+#pragma endregion
+
+
+
+
+#pragma region GENERATE GRAPH
+#ifdef OPENMP
+/**
+ * Build a CSR graph from generated edges, with all vertices present.
+ * @param a output csr graph (output)
+ * @param edges lists of generated edges (u, v, w), one per thread
+ * @param N number of vertices (1-based vertex ids)
+ * @param symmetric add reverse edges too? [false]
+ */
+template <class G, class K, class E>
+inline void generateGraphCsrOmpW(G& a, const vector2d<tuple<K, K, E>>& edges, size_t N, bool symmetric=false) {
+  csrCreateFromEdgesOmpW(a, edges, N+1, symmetric, true);
+}
+#endif
+#pragma endregion
+#pragma endregion
@@ -1,8 +1,14 @@
 #pragma once
 #include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <stdexcept>
+#include <exception>
+#include <type_traits>
 #include <utility>
 #include <tuple>
 #include <string>
+#include <string_view>
 #include <istream>
 #include <sstream>
 #include <iostream>
@@ -10,13 +16,18 @@
 #include "_main.hxx"
 #include "Graph.hxx"
 #include "update.hxx"
+#include "csr.hxx"
 #include "selfLoop.hxx"
 #ifdef OPENMP
 #include <omp.h>
 #endif
 
 using std::tuple;
+using std::get;
+using std::is_floating_point;
+using std::is_same;
 using std::string;
+using std::string_view;
 using std::istream;
 using std::ostream;
 using std::istringstream;
@@ -27,6 +38,10 @@ using std::make_tuple;
 using std::replace;
 using std::getline;
 using std::to_string;
+using std::runtime_error;
+using std::exception_ptr;
+using std::current_exception;
+using std::rethrow_exception;
 
 
 
@@ -69,6 +84,36 @@ inline void readVectorW(vector<T>& a, istream& stream, bool keyed=false, int sta
 
 
 
+#pragma region READ BATCH UPDATE
+/**
+ * Read a batch update from a stream.
+ * @param deletions edge deletions (output)
+ * @param insertions edge insertions (output)
+ * @param stream input stream
+ * @param weighted is batch update weighted? [false]
+ * @note Each line is "+ u v [w]" for an insertion, or "- u v" for a deletion.
+ * Other lines, such as comments, are skipped.
+ */
+template <class K, class E>
+inline void readBatchUpdateW(vector<tuple<K, K, E>>& deletions, vector<tuple<K, K, E>>& insertions, istream& stream, bool weighted=false) {
+  string line;
+  deletions.clear();
+  insertions.clear();
+  while (getline(stream, line)) {
+    replace(line.begin(), line.end(), ',', ' ');
+    istringstream lstream(line);
+    string op; size_t u = 0, v = 0; double w = 1;
+    if (!(lstream >> op >> u >> v)) continue;
+    if (weighted) lstream >> w;
+    if (op=="+") insertions.emplace_back(K(u), K(v), E(w));
+    else if (op=="-") deletions.emplace_back(K(u), K(v), E(w));
+  }
+}
+#pragma endregion
+
+
+
+
 #pragma region READ EDGELIST FORMAT
 /**
  * Read a file in Edgelist format (also supports CSV and TSV).
@@ -92,43 +137,214 @@ inline void readEdgelistFormatDo(istream& stream, bool weighted, bool symmetric,
 }
 
 
+/**
+ * Read an edge from a line in Edgelist format (also supports CSV and TSV).
+ * @param u source vertex (output)
+ * @param v target vertex (output)
+ * @param w edge weight (output)
+ * @param ib begin iterator of line
+ * @param ie end iterator of line
+ * @param weighted is graph weighted?
+ * @returns true if an edge was read (false for blank/comment lines)
+ */
+template <class I>
+inline bool readEdgelistLineW(size_t& u, size_t& v, double& w, I ib, I ie, bool weighted) {
+  auto fu = [](char c) { return c==','; };
+  ib = findNextNonBlank(ib, ie, fu);
+  if (ib==ie || !isDigit(*ib)) return false;
+  ib = parseWholeNumberW(u, ib, ie);
+  ib = findNextDigit(ib, ie);
+  if (ib==ie) return false;
+  ib = parseWholeNumberW(v, ib, ie);
+  w  = 1;
+  if (weighted) { w = 0; readNumberW(w, ib, ie, fu, fu); }
+  return true;
+}
+
+
+/**
+ * Find the beginning of the line containing the i-th of n equal parts of a text.
+ * @param ib begin iterator of text
+ * @param ie end iterator of text
+ * @param i part index
+ * @param n number of parts
+ * @returns iterator to beginning of the line after the i-th split point
+ */
+template <class I>
+inline I findLineSplit(I ib, I ie, size_t i, size_t n) {
+  if (i==0) return ib;
+  if (i>=n) return ie;
+  return findNextLine(ib + (ie-ib)*i/n, ie);
+}
+
+
 #ifdef OPENMP
 /**
  * Read a file in Edgelist format (also supports CSV and TSV).
- * @param stream input stream
+ * @param data file contents (memory mapped)
  * @param weighted is graph weighted?
  * @param symmetric is graph symmetric?
- * @param fb on body line (u, v, w)
+ * @param fs on block (S, n), with 1 + largest vertex id and number of bytes read so far, called from a single thread after a block is parsed, before its vertices
+ * @param fv on vertex (u), before its edges, called from the thread that owns u
+ * @param fb on body line (u, v, w), called from the thread that owns u (see belongsOmp())
+ * @param block number of bytes to parse at a time [0 => 32 MiB]
+ * @note The data is split into byte ranges at line boundaries, and parsed in parallel.
+ * Parsed edges (and their targets) are then bucketed by the thread that owns their
+ * source (target) vertex, so that each thread only processes its own vertices and
+ * edges, in the order they were read. All of this happens in a single parallel
+ * region, so that the buckets always match the number of threads running.
  */
-template <class FB>
-inline void readEdgelistFormatDoOmp(istream& stream, bool weighted, bool symmetric, FB fb) {
-  const int LINES = 131072;
-  vector<string> lines(LINES);
-  vector<tuple<size_t, size_t, double>> edges(LINES);
-  while (true) {
-    // Read several lines from the stream.
-    int READ = 0;
-    for (int i=0; i<LINES; ++i, ++READ)
-      if (!getline(stream, lines[i])) break;
-    if (READ==0) break;
-    // Parse lines using multiple threads.
-    #pragma omp parallel for schedule(dynamic, 1024)
-    for (int i=0; i<READ; ++i) {
-      replace(lines[i].begin(), lines[i].end(), ',', ' ');
-      char *line = (char*) lines[i].c_str();
-      size_t u = strtoull(line, &line, 10);
-      size_t v = strtoull(line, &line, 10);
-      double w = weighted? strtod(line, &line) : 0;
-      edges[i] = {u, v, weighted? w : 1};
-    }
-    // Notify parsed lines.
-    #pragma omp parallel
+template <class FS, class FV, class FB>
+inline void readEdgelistFormatDoOmp(string_view data, bool weighted, bool symmetric, FS fs, FV fv, FB fb, size_t block=0) {
+  using  EDGE  = tuple<size_t, size_t, double>;
+  const size_t BLOCK = block? block : 32 * 1024 * 1024;
+  const char *db = data.data();
+  const char *de = db + data.size();
+  vector<vector<EDGE>*>   edges, buckets;
+  vector<vector<size_t>*> targets, offsets, toffsets;
+  vector<size_t> spans;
+  size_t S = 0;
+  exception_ptr error;
+  #pragma omp parallel
+  {
+    const int T = omp_get_num_threads();
+    const int t = omp_get_thread_num();
+    // Allocate edge buffers, buckets, and bucket offsets for each thread.
+    #pragma omp single
     {
-      for (int i=0; i<READ; ++i) {
-        const auto& [u, v, w] = edges[i];
-        fb(u, v, w);
-        if (symmetric) fb(v, u, w);
+      edges.resize(T);
+      buckets.resize(T);
+      targets.resize(T);
+      offsets.resize(T);
+      toffsets.resize(T);
+      spans.resize(T);
+    }
+    edges[t]    = new vector<EDGE>();
+    buckets[t]  = new vector<EDGE>();
+    targets[t]  = new vector<size_t>();
+    offsets[t]  = new vector<size_t>(T+1);
+    toffsets[t] = new vector<size_t>(T+1);
+    auto& es = *edges[t];
+    auto& bs = *buckets[t];
+    auto& vs = *targets[t];
+    auto& os = *offsets[t];
+    auto& ps = *toffsets[t];
+    for (const char *bb=db; bb<de;) {
+      const char *be = size_t(de-bb)<=BLOCK? de : findNextLine(bb+BLOCK, de);
+      // Parse lines in the byte range of this thread.
+      const char *ib = findLineSplit(bb, be, t,   T);
+      const char *ie = findLineSplit(bb, be, t+1, T);
+      es.clear();
+      for (const char *it=ib; it<ie;) {
+        const char *le = findNextLine(it, ie);
+        size_t u = 0, v = 0; double w = 1;
+        if (readEdgelistLineW(u, v, w, it, le, weighted)) {
+          es.emplace_back(u, v, w);
+          spans[t] = max(spans[t], max(u, v) + 1);
+        }
+        it = le;
+      }
+      // Count the edges (and targets) belonging to each thread.
+      fillValueU(os, size_t());
+      fillValueU(ps, size_t());
+      for (const auto& [u, v, w] : es) {
+        ++os[ownerOmp(u, T) + 1];
+        if (symmetric) ++os[ownerOmp(v, T) + 1];
+        else           ++ps[ownerOmp(v, T) + 1];
+      }
+      inclusiveScanW(os, os);
+      inclusiveScanW(ps, ps);
+      // Scatter the edges (and targets) into per-thread buckets, preserving their order.
+      bs.resize(os[T]);
+      vs.resize(ps[T]);
+      for (const auto& [u, v, w] : es) {
+        bs[os[ownerOmp(u, T)]++] = {u, v, w};
+        if (symmetric) bs[os[ownerOmp(v, T)]++] = {v, u, w};
+        else           vs[ps[ownerOmp(v, T)]++] = v;
+      }
+      #pragma omp barrier
+      // Notify the span of the vertices read so far.
+      #pragma omp single
+      {
+        for (int i=0; i<T; ++i)
+          S = max(S, spans[i]);
+        try { fs(S, size_t(be-db)); }
+        catch (...) { error = current_exception(); }
+      }
+      if (error) break;
+      // Notify each thread of its own vertices, and then of its own edges, in order.
+      for (int i=0; i<T; ++i) {
+        const auto& bi = *buckets[i];
+        const auto& vi = *targets[i];
+        const auto& oi = *offsets[i];
+        const auto& pi = *toffsets[i];
+        for (size_t j=t? oi[t-1] : 0, J=oi[t]; j<J; ++j)
+          fv(get<0>(bi[j]));
+        for (size_t j=t? pi[t-1] : 0, J=pi[t]; j<J; ++j)
+          fv(vi[j]);
+      }
+      #pragma omp barrier
+      for (int i=0; i<T; ++i) {
+        const auto& bi = *buckets[i];
+        const auto& oi = *offsets[i];
+        for (size_t j=t? oi[t-1] : 0, J=oi[t]; j<J; ++j) {
+          const auto& [u, v, w] = bi[j];
+          fb(u, v, w);
+        }
       }
+      #pragma omp barrier
+      bb = be;
+    }
+    // Free edge buffers.
+    delete edges[t];
+    delete buckets[t];
+    delete targets[t];
+    delete offsets[t];
+    delete toffsets[t];
+  }
+  if (error) rethrow_exception(error);
+}
+
+
+/**
+ * Read a file in Edgelist format (also supports CSV and TSV).
+ * @param data file contents (memory mapped)
+ * @param weighted is graph weighted?
+ * @param symmetric is graph symmetric?
+ * @param fb on body line (u, v, w), called from the thread that owns u (see belongsOmp())
+ */
+template <class FB>
+inline void readEdgelistFormatDoOmp(string_view data, bool weighted, bool symmetric, FB fb) {
+  auto fs = [](auto S, auto n) {};
+  auto fv = [](auto u) {};
+  readEdgelistFormatDoOmp(data, weighted, symmetric, fs, fv, fb);
+}
+#endif
+
+
+#ifdef OPENMP
+/**
+ * Read a file in Edgelist format into lists of edges, one per thread.
+ * @param a lists of edges (u, v, w), one per thread (output)
+ * @param data file contents (memory mapped)
+ * @param weighted is graph weighted?
+ */
+template <class K, class E>
+inline void readEdgelistFormatListsOmpW(vector2d<tuple<K, K, E>>& a, string_view data, bool weighted) {
+  const int T = omp_get_max_threads();
+  const char *db = data.data();
+  const char *de = db + data.size();
+  a.clear();
+  a.resize(T);
+  #pragma omp parallel for schedule(static, 1)
+  for (int t=0; t<T; ++t) {
+    const char *ib = findLineSplit(db, de, t,   T);
+    const char *ie = findLineSplit(db, de, t+1, T);
+    for (const char *it=ib; it<ie;) {
+      const char *le = findNextLine(it, ie);
+      size_t u = 0, v = 0; double w = 1;
+      if (readEdgelistLineW(u, v, w, it, le, weighted)) a[t].emplace_back(K(u), K(v), E(w));
+      it = le;
     }
   }
 }
@@ -159,22 +375,78 @@ inline void readGraphEdgelistFormatW(G& a, istream& stream, bool weighted=false,
 /**
  * Read a file in Edgelist format as a graph.
  * @param a output graph (output)
- * @param stream input stream
+ * @param data file contents (memory mapped)
  * @param weighted is graph weighted? [false]
  * @param symmetric is graph symmetric? [false]
  * @param span maximum number of vertices [0 => no limit]
  */
 template <class G>
-inline void readGraphEdgelistFormatOmpW(G& a, istream& stream, bool weighted=false, bool symmetric=false, size_t span=0) {
+inline void readGraphEdgelistFormatOmpW(G& a, string_view data, bool weighted=false, bool symmetric=false, size_t span=0) {
   using K = typename G::key_type;
   using E = typename G::edge_value_type;
+  auto fs = [&](auto S, auto n) { if (S > a.span()) a.respan(S); };
+  auto fv = [&](auto u) { a.addVertex(K(u)); };
   auto fb = [&](auto u, auto v, auto w) { addEdgeOmpU(a, K(u), K(v), E(w)); };
   a.clear();
   if (span) a.respan(span);
-  readEdgelistFormatDoOmp(stream, weighted, symmetric, fb);
+  readEdgelistFormatDoOmp(data, weighted, symmetric, fs, fv, fb);
   updateOmpU(a);
 }
 #endif
+
+
+#ifdef OPENMP
+/**
+ * Read a file in Edgelist format as a CSR graph.
+ * @param a output csr graph (output)
+ * @param data file contents (memory mapped)
+ * @param weighted is graph weighted? [false]
+ * @param symmetric is graph symmetric? [false]
+ * @param span minimum number of vertices [0]
+ */
+template <class K, class V, class E, class O>
+inline void readGraphEdgelistFormatOmpW(DiGraphCsr<K, V, E, O>& a, string_view data, bool weighted=false, bool symmetric=false, size_t span=0) {
+  vector2d<tuple<K, K, E>> edges;
+  readEdgelistFormatListsOmpW(edges, data, weighted);
+  csrCreateFromEdgesOmpW(a, edges, span, symmetric);
+}
+#endif
+
+
+#ifdef OPENMP
+/**
+ * Check if a file in Edgelist format needs 64-bit vertex ids.
+ * @param data file contents (memory mapped)
+ * @returns true if a whole number in the file does not fit a 32-bit vertex id
+ * @note Only runs of 10 or more digits, not following a decimal point, are
+ * parsed, so this is much faster than reading the graph. Large integral
+ * weights also count, which only leads to wider vertex ids than necessary.
+ */
+inline bool hasWideKeysEdgelistFormatOmp(string_view data) {
+  const size_t BLOCK = 1 << 20;
+  const size_t LIMIT = UINT32_MAX;
+  const char *ib = data.data();
+  size_t N = data.size();
+  bool a = false;
+  #pragma omp parallel for schedule(dynamic, 1) reduction(||:a)
+  for (size_t b=0; b<N; b+=BLOCK) {
+    size_t e = min(b+BLOCK, N);
+    // Each number is checked by the block in which it begins.
+    for (size_t i=b; i<e && !a; ++i) {
+      if (!isDigit(ib[i]) || (i>0 && isDigit(ib[i-1]))) continue;
+      size_t j = i, x = 0;
+      while (j<N && isDigit(ib[j])) ++j;
+      if (j-i>=10 && (i==0 || ib[i-1]!='.')) {
+        for (size_t k=i; k<j && x<LIMIT; ++k)
+          x = 10*x + (ib[k]-'0');
+        a = x>=LIMIT;
+      }
+      i = j;
+    }
+  }
+  return a;
+}
+#endif
 #pragma endregion
 
 
@@ -203,6 +475,33 @@ inline void readCooFormatHeaderW(size_t& rows, size_t& cols, size_t &size, istre
 }
 
 
+/**
+ * Read header of COO format file.
+ * @param rows number of rows (output)
+ * @param cols number of columns (output)
+ * @param size number of lines/edges (output)
+ * @param data file contents
+ * @returns offset of the first body line
+ */
+inline size_t readCooFormatHeaderW(size_t& rows, size_t& cols, size_t &size, string_view data) {
+  auto fu = [](char c) { return false; };
+  const char *ib = data.data();
+  const char *ie = ib + data.size();
+  // Skip past empty lines and comments.
+  for (const char *it=ib; it<ie;) {
+    const char *le = findNextLine(it, ie);
+    const char *tb = findNextNonBlank(it, le, fu);
+    if (tb==le || isNewline(*tb) || *tb=='%' || *tb=='#') { it = le; continue; }
+    // Read rows, cols, size.
+    tb = findNextDigit(tb, le); tb = parseWholeNumberW(rows, tb, le);
+    tb = findNextDigit(tb, le); tb = parseWholeNumberW(cols, tb, le);
+    tb = findNextDigit(tb, le); tb = parseWholeNumberW(size, tb, le);
+    return le - ib;
+  }
+  return ie - ib;
+}
+
+
 /**
  * Read a file in COO format as a graph.
  * @param a output graph (output)
@@ -228,23 +527,45 @@ inline void readGraphCooFormatW(G& a, istream& stream, bool weighted=false, bool
 /**
  * Read a file in COO format as a graph.
  * @param a output graph (output)
- * @param stream input stream
+ * @param data file contents (memory mapped)
  * @param weighted is graph weighted? [false]
  * @param symmetric is graph symmetric? [false]
  */
 template <class G>
-inline void readGraphCooFormatOmpW(G& a, istream& stream, bool weighted=false, bool symmetric=false) {
+inline void readGraphCooFormatOmpW(G& a, string_view data, bool weighted=false, bool symmetric=false) {
   using K = typename G::key_type;
   using E = typename G::edge_value_type;
+  auto fs = [&](auto S, auto n) { if (S > a.span()) a.respan(S); };
+  auto fv = [&](auto u) { a.addVertex(K(u)); };
   auto fb = [&](auto u, auto v, auto w) { addEdgeOmpU(a, K(u), K(v), E(w)); };
   size_t rows = 0, cols = 0, size = 0;
   a.clear();
-  readCooFormatHeaderW(rows, cols, size, stream);
+  size_t o = readCooFormatHeaderW(rows, cols, size, data);
   addVerticesU(a, K(1), K(max(rows, cols) + 1));
-  readEdgelistFormatDoOmp(stream, weighted, symmetric, fb);
+  readEdgelistFormatDoOmp(data.substr(o), weighted, symmetric, fs, fv, fb);
   updateOmpU(a);
 }
 #endif
+
+
+#ifdef OPENMP
+/**
+ * Read a file in COO format as a CSR graph.
+ * @param a output csr graph (output)
+ * @param data file contents (memory mapped)
+ * @param weighted is graph weighted? [false]
+ * @param symmetric is graph symmetric? [false]
+ */
+template <class K, class V, class E, class O>
+inline void readGraphCooFormatOmpW(DiGraphCsr<K, V, E, O>& a, string_view data, bool weighted=false, bool symmetric=false) {
+  size_t rows = 0, cols = 0, size = 0;
+  vector2d<tuple<K, K, E>> edges;
+  size_t o = readCooFormatHeaderW(rows, cols, size, data);
+  size_t N = max(rows, cols);
+  readEdgelistFormatListsOmpW(edges, data.substr(o), weighted);
+  csrCreateFromEdgesOmpW(a, edges, N+1, symmetric, true);
+}
+#endif
 #pragma endregion
 
 
@@ -276,6 +597,37 @@ inline void readMtxFormatHeader(bool& symmetric, size_t& rows, size_t& cols, siz
 }
 
 
+/**
+ * Read header of MTX format file.
+ * @param symmetric is graph symmetric (output)
+ * @param rows number of rows (output)
+ * @param cols number of columns (output)
+ * @param size number of lines/edges (output)
+ * @param data file contents
+ * @returns offset of the first body line
+ */
+inline size_t readMtxFormatHeader(bool& symmetric, size_t& rows, size_t& cols, size_t& size, string_view data) {
+  string h0, h1, h2, h3, h4;
+  const char *ib = data.data();
+  const char *ie = ib + data.size();
+  const char *it = ib;
+  // Skip past empty lines and comments, and read the graph type.
+  for (; it<ie; it=findNextLine(it, ie)) {
+    if (*it!='%') break;
+    if (ie-it<2 || it[1]!='%') continue;
+    istringstream lstream(string(it, findNextLine(it, ie)));
+    lstream >> h0 >> h1 >> h2 >> h3 >> h4;
+  }
+  if (h1!="matrix" || h2!="coordinate") throw FormatError("Invalid MTX header (unknown format)");
+  symmetric = h4=="symmetric" || h4=="skew-symmetric";
+  // Read rows, cols, size.
+  const char *le = findNextLine(it, ie);
+  istringstream lstream(string(it, le));
+  lstream >> rows >> cols >> size;
+  return le - ib;
+}
+
+
 /**
  * Read a file in MTX format as a graph.
  * @param a output graph (output)
@@ -300,22 +652,44 @@ inline void readGraphMtxFormatW(G& a, istream& stream, bool weighted=false) {
 /**
  * Read a file in MTX format as a graph.
  * @param a output graph (output)
- * @param stream input stream
+ * @param data file contents (memory mapped)
  * @param weighted is graph weighted? [false]
  */
 template <class G>
-inline void readGraphMtxFormatOmpW(G& a, istream& stream, bool weighted=false) {
+inline void readGraphMtxFormatOmpW(G& a, string_view data, bool weighted=false) {
   using K = typename G::key_type;
   using E = typename G::edge_value_type;
+  auto fs = [&](auto S, auto n) { if (S > a.span()) a.respan(S); };
+  auto fv = [&](auto u) { a.addVertex(K(u)); };
   auto fb = [&](auto u, auto v, auto w) { addEdgeOmpU(a, K(u), K(v), E(w)); };
   bool symmetric = false; size_t rows = 0, cols = 0, size = 0;
   a.clear();
-  readMtxFormatHeader(symmetric, rows, cols, size, stream);
+  size_t o = readMtxFormatHeader(symmetric, rows, cols, size, data);
   addVerticesU(a, K(1), K(max(rows, cols) + 1));
-  readEdgelistFormatDoOmp(stream, weighted, symmetric, fb);
+  readEdgelistFormatDoOmp(data.substr(o), weighted, symmetric, fs, fv, fb);
   updateOmpU(a);
 }
 #endif
+
+
+#ifdef OPENMP
+/**
+ * Read a file in MTX format as a CSR graph.
+ * @param a output csr graph (output)
+ * @param data file contents (memory mapped)
+ * @param weighted is graph weighted? [false]
+ * @param symmetrize add reverse edges, even if the graph is not symmetric? [false]
+ */
+template <class K, class V, class E, class O>
+inline void readGraphMtxFormatOmpW(DiGraphCsr<K, V, E, O>& a, string_view data, bool weighted=false, bool symmetrize=false) {
+  bool symmetric = false; size_t rows = 0, cols = 0, size = 0;
+  vector2d<tuple<K, K, E>> edges;
+  size_t o = readMtxFormatHeader(symmetric, rows, cols, size, data);
+  size_t N = max(rows, cols);
+  readEdgelistFormatListsOmpW(edges, data.substr(o), weighted);
+  csrCreateFromEdgesOmpW(a, edges, N+1, symmetric || symmetrize, true);
+}
+#endif
 #pragma endregion
 
 
@@ -340,6 +714,7 @@ inline void readGraphAdjFormatInternalW(G& a, istream& stream, FU fu) {
   while (true) {
     if (!getline(stream, line) || line.size() < 2) throw FormatError(ENOHEADER);
     if (line[0]=='#' || line=="AdjacencyGraph") continue;
+    break;
   }
   size_t n = strtoull(line.c_str(), nullptr, 10);
   if (!getline(stream, line)) throw FormatError(ENOHEADER);
@@ -397,6 +772,427 @@ inline void readGraphAdjFormatOmpW(G& a, istream& stream) {
 
 
 
+#pragma region BINARY FORMAT
+/**
+ * Header of a graph in binary (CSR) format.
+ * @note The header is followed by 64-byte aligned sections: vertex existence
+ * flags [span], offsets [span+1], edge keys [size], and edge values [size] (if weighted).
+ */
+struct GraphBinaryHeader {
+  #pragma region CONSTANTS
+  /** Magic string identifying the format. */
+  static constexpr const char *MAGIC = "GVEGRAPH";
+  /** Current version of the format. */
+  static constexpr uint32_t FORMAT_VERSION = 1;
+  /** Graph is weighted (edge values section is present). */
+  static constexpr uint8_t WEIGHTED  = 0x01;
+  /** Graph is symmetric. */
+  static constexpr uint8_t SYMMETRIC = 0x02;
+  /** Edge values are floating-point numbers. */
+  static constexpr uint8_t REAL      = 0x04;
+  /** Alignment of each section, in bytes. */
+  static constexpr size_t  ALIGN     = 64;
+  #pragma endregion
+
+
+  #pragma region DATA
+  /** Magic string "GVEGRAPH". */
+  char     magic[8];
+  /** Version of the format. */
+  uint32_t version;
+  /** Width of vertex ids, in bytes. */
+  uint8_t  keyBytes;
+  /** Width of edge offsets, in bytes. */
+  uint8_t  offsetBytes;
+  /** Width of edge values, in bytes (0 if unweighted). */
+  uint8_t  edgeValueBytes;
+  /** Flags (WEIGHTED, SYMMETRIC, REAL). */
+  uint8_t  flags;
+  /** Span of vertex ids. */
+  uint64_t span;
+  /** Number of vertices. */
+  uint64_t order;
+  /** Number of edges. */
+  uint64_t size;
+  /** Checksum of all sections following the header. */
+  uint64_t checksum;
+  /** Reserved for future use (zero). */
+  uint64_t reserved[2];
+  #pragma endregion
+
+
+  #pragma region METHODS
+  /**
+   * Get the byte offset of each section, and the total file size.
+   * @returns [exists, offsets, edge keys, edge values, end]
+   */
+  inline auto layout() const noexcept {
+    auto fa = [](size_t x) { return ceilDiv(x, ALIGN) * ALIGN; };
+    size_t e0 = fa(sizeof(GraphBinaryHeader));
+    size_t e1 = fa(e0 + span);
+    size_t e2 = fa(e1 + (span+1) * offsetBytes);
+    size_t e3 = fa(e2 + size * keyBytes);
+    size_t e4 = fa(e3 + size * edgeValueBytes);
+    return make_tuple(e0, e1, e2, e3, e4);
+  }
+  #pragma endregion
+};
+
+
+/**
+ * Compute the checksum of a block of bytes.
+ * @param data block of bytes
+ * @param N number of bytes
+ * @returns 64-bit checksum (independent of number of threads)
+ */
+inline uint64_t binaryChecksumOmp(const char *data, size_t N) {
+  const size_t CHUNK = 1024 * 1024;
+  const uint64_t PRIME = 0x100000001B3ULL;
+  size_t C = ceilDiv(N, CHUNK);
+  vector<uint64_t> hashes(C);
+  // Hash each chunk, 8 bytes at a time (FNV-1a style).
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (size_t c=0; c<C; ++c) {
+    size_t i = c*CHUNK, I = min(i+CHUNK, N);
+    uint64_t h = 0xCBF29CE484222325ULL;
+    for (; i+8<=I; i+=8) {
+      uint64_t x; memcpy(&x, data+i, 8);
+      h = (h ^ x) * PRIME;
+    }
+    for (; i<I; ++i)
+      h = (h ^ uint8_t(data[i])) * PRIME;
+    hashes[c] = h;
+  }
+  // Combine chunk hashes in order.
+  uint64_t a = N;
+  for (size_t c=0; c<C; ++c)
+    a = (a ^ hashes[c]) * PRIME;
+  return a;
+}
+
+
+/**
+ * Read the header of a graph in binary format.
+ * @param data file contents
+ * @param verify verify checksum of the file? [false]
+ * @returns header of the file
+ */
+inline GraphBinaryHeader readGraphBinaryFormatHeader(string_view data, bool verify=false) {
+  GraphBinaryHeader h;
+  if (data.size() < sizeof(h)) throw FormatError("Invalid binary graph format (missing header)");
+  memcpy(&h, data.data(), sizeof(h));
+  if (memcmp(h.magic, GraphBinaryHeader::MAGIC, 8)!=0) throw FormatError("Invalid binary graph format (bad magic)");
+  if (h.version!=GraphBinaryHeader::FORMAT_VERSION) throw FormatError("Invalid binary graph format (unsupported version)");
+  auto e4 = get<4>(h.layout());
+  if (data.size() < e4) throw FormatError("Invalid binary graph format (truncated)");
+  if (verify && binaryChecksumOmp(data.data() + sizeof(h), e4 - sizeof(h)) != h.checksum) throw FormatError("Invalid binary graph format (checksum mismatch)");
+  return h;
+}
+
+
+/**
+ * Read a value of given width from a binary graph section.
+ * @tparam T value type
+ * @param p pointer to value
+ * @param bytes width of value
+ * @param real is value floating-point?
+ * @returns value
+ */
+template <class T>
+inline T readBinaryValue(const char *p, int bytes, bool real) {
+  if (real && bytes==4) { float    x; memcpy(&x, p, 4); return T(x); }
+  if (real && bytes==8) { double   x; memcpy(&x, p, 8); return T(x); }
+  if (bytes==1)         { uint8_t  x; memcpy(&x, p, 1); return T(x); }
+  if (bytes==2)         { uint16_t x; memcpy(&x, p, 2); return T(x); }
+  if (bytes==4)         { uint32_t x; memcpy(&x, p, 4); return T(x); }
+  uint64_t x; memcpy(&x, p, 8); return T(x);
+}
+
+
+#ifdef OPENMP
+/**
+ * Read a graph in binary format (copying it into the graph).
+ * @param a output graph (output)
+ * @param data file contents (memory mapped)
+ * @param verify verify checksum of the file? [true]
+ */
+template <class G>
+inline void readGraphBinaryFormatOmpW(G& a, string_view data, bool verify=true) {
+  using K = typename G::key_type;
+  using E = typename G::edge_value_type;
+  auto h = readGraphBinaryFormatHeader(data, verify);
+  auto [e0, e1, e2, e3, e4] = h.layout();
+  const char *ex = data.data() + e0;
+  const char *os = data.data() + e1;
+  const char *ks = data.data() + e2;
+  const char *vs = data.data() + e3;
+  int  OB = h.offsetBytes, KB = h.keyBytes, EB = h.edgeValueBytes;
+  bool real = h.flags & GraphBinaryHeader::REAL;
+  size_t S  = h.span;
+  a.clear();
+  a.respan(S);
+  for (size_t u=0; u<S; ++u)
+    if (ex[u]) a.addVertex(K(u));
+  // Add the edges of each vertex in parallel.
+  #pragma omp parallel for schedule(dynamic, 2048)
+  for (size_t u=0; u<S; ++u) {
+    size_t i = readBinaryValue<size_t>(os + u*OB,     OB, false);
+    size_t I = readBinaryValue<size_t>(os + (u+1)*OB, OB, false);
+    a.reserveEdges(K(u), I-i);
+    for (; i<I; ++i) {
+      K v = readBinaryValue<K>(ks + i*KB, KB, false);
+      E w = EB? readBinaryValue<E>(vs + i*EB, EB, real) : E(1);
+      a.addEdge(K(u), v, w);
+    }
+  }
+  updateOmpU(a);
+}
+#endif
+
+
+/**
+ * Map a graph in binary format as a read-only CSR graph, without copying.
+ * @param a output graph view (output)
+ * @param pth file path
+ * @param verify verify checksum of the file? [false]
+ */
+template <class K, class V, class E, class O>
+inline void mapGraphBinaryFormatW(DiGraphCsrView<K, V, E, O>& a, const char *pth, bool verify=false) {
+  MappedFile file(pth, MADV_RANDOM);
+  auto h = readGraphBinaryFormatHeader(file.view(), verify);
+  auto [e0, e1, e2, e3, e4] = h.layout();
+  bool real = h.flags & GraphBinaryHeader::REAL;
+  if (h.keyBytes!=sizeof(K) || h.offsetBytes!=sizeof(O)) throw FormatError("Binary graph format has different key/offset width");
+  if (h.edgeValueBytes && (h.edgeValueBytes!=sizeof(E) || real!=is_floating_point<E>::value)) throw FormatError("Binary graph format has different edge value type");
+  const char *data = file.data();
+  a.N = h.order;
+  a.S = h.span;
+  a.exists     = (const uint8_t*) (data + e0);
+  a.offsets    = (const O*) (data + e1);
+  a.edgeKeys   = (const K*) (data + e2);
+  a.edgeValues = h.edgeValueBytes? (const E*) (data + e3) : nullptr;
+  a.file       = move(file);
+}
+
+
+#ifdef OPENMP
+/**
+ * Write a graph in binary format.
+ * @param pth output file path
+ * @param x input graph
+ * @param weighted is graph weighted? [false]
+ * @param symmetric is graph symmetric? [false]
+ * @note The file is pre-sized and memory mapped, and filled in parallel.
+ */
+template <class G>
+inline void writeGraphBinaryFormatOmp(const char *pth, const G& x, bool weighted=false, bool symmetric=false) {
+  using K = typename G::key_type;
+  using E = typename G::edge_value_type;
+  using O = uint64_t;
+  constexpr bool REAL = is_floating_point<E>::value;
+  size_t S = x.span();
+  int    T = omp_get_max_threads();
+  // A graph without edge values is always written unweighted.
+  if constexpr (is_same<E, None>::value) weighted = false;
+  // Obtain offsets of the outgoing edges of vertices.
+  vector<O> offsets(S+1), buf(T);
+  #pragma omp parallel for schedule(static, 2048)
+  for (size_t u=0; u<S; ++u)
+    offsets[u] = x.degree(K(u));
+  O M = exclusiveScanOmpW(offsets.data(), buf.data(), offsets.data(), S);
+  offsets[S] = M;
+  // Prepare the header.
+  GraphBinaryHeader h = {};
+  memcpy(h.magic, GraphBinaryHeader::MAGIC, 8);
+  h.version        = GraphBinaryHeader::FORMAT_VERSION;
+  h.keyBytes       = sizeof(K);
+  h.offsetBytes    = sizeof(O);
+  h.edgeValueBytes = weighted? sizeof(E) : 0;
+  h.flags          = (weighted? GraphBinaryHeader::WEIGHTED : 0) | (symmetric? GraphBinaryHeader::SYMMETRIC : 0) | (weighted && REAL? GraphBinaryHeader::REAL : 0);
+  h.span  = S;
+  h.order = x.order();
+  h.size  = M;
+  auto [e0, e1, e2, e3, e4] = h.layout();
+  // Fill the sections in parallel.
+  auto file = MappedFile::create(pth, e4);
+  char *data = file.data();
+  uint8_t *ex = (uint8_t*) (data + e0);
+  K *ks = (K*) (data + e2);
+  E *vs = (E*) (data + e3);
+  memcpy(data + e1, offsets.data(), (S+1) * sizeof(O));
+  #pragma omp parallel for schedule(dynamic, 2048)
+  for (size_t u=0; u<S; ++u) {
+    size_t i = offsets[u];
+    ex[u] = x.hasVertex(K(u))? 1 : 0;
+    x.forEachEdge(K(u), [&](auto v, auto w) {
+      ks[i] = v;
+      if (weighted) vs[i] = w;
+      ++i;
+    });
+  }
+  // Write the header, with checksum.
+  h.checksum = binaryChecksumOmp(data + sizeof(h), e4 - sizeof(h));
+  memcpy(data, &h, sizeof(h));
+}
+#endif
+#pragma endregion
+
+
+
+
+#pragma region WRITE VECTOR
+/**
+ * Write selected entries of a vector to a stream.
+ * @param stream output stream
+ * @param x vector to write
+ * @param keyed write index with each value? [false]
+ * @param start start index [0]
+ * @param ft should entry be written? (index)
+ */
+template <class T, class FT>
+inline void writeVectorIf(ostream& stream, const vector<T>& x, bool keyed, int start, FT ft) {
+  for (size_t i=max(0, start); i<x.size(); ++i) {
+    if (!ft(i)) continue;
+    if (keyed) stream << i-start << ' ';
+    stream << x[i] << '\n';
+  }
+}
+
+
+/**
+ * Write a vector to a stream.
+ * @param stream output stream
+ * @param x vector to write
+ * @param keyed write index with each value? [false]
+ * @param start start index [0]
+ */
+template <class T>
+inline void writeVector(ostream& stream, const vector<T>& x, bool keyed=false, int start=0) {
+  auto ft = [](size_t i) { return true; };
+  writeVectorIf(stream, x, keyed, start, ft);
+}
+#pragma endregion
+
+
+
+
+#pragma region WRITE TEXT
+/**
+ * Create a file for writing (truncated if it exists).
+ * @param pth file path
+ * @returns file descriptor
+ * @throws runtime_error if file could not be created
+ */
+inline int createFileW(const char *pth) {
+  int fd = ::open(pth, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd<0) throw runtime_error(string("Failed to create file: ") + pth);
+  return fd;
+}
+
+
+/**
+ * Write bytes to a file, at a given position.
+ * @param fd file descriptor
+ * @param data bytes to write
+ * @param N number of bytes
+ * @param o byte offset in file
+ * @returns success?
+ */
+inline bool writeBytesAt(int fd, const char *data, size_t N, size_t o) {
+  while (N>0) {
+    ssize_t n = ::pwrite(fd, data, N, off_t(o));
+    if (n<0 && errno==EINTR) continue;
+    if (n<=0) return false;
+    data += n; N -= n; o += n;
+  }
+  return true;
+}
+
+
+#ifdef OPENMP
+/**
+ * Write the text of a range of items to a file, in parallel.
+ * @param fd file descriptor
+ * @param o byte offset in file to start writing at
+ * @param N number of items
+ * @param fw append text of an item (buffer, item index)
+ * @returns byte offset in file, after the written text
+ * @throws runtime_error if file could not be written
+ * @note Chunks of items are formatted into reused per-thread buffers. A
+ * prefix sum over the chunk sizes gives the position of each chunk in the
+ * file, which is extended to fit, and the chunks are then written with
+ * pwrite() in parallel. The output is the same for any number of threads.
+ */
+template <class FW>
+inline size_t writeTextOmpW(int fd, size_t o, size_t N, FW fw) {
+  const size_t CHUNK = 1024;  // Items per chunk
+  const size_t ROUND = 256;   // Chunks per round
+  // Allocate a text buffer for each thread.
+  int T = omp_get_max_threads();
+  vector<string*> texts(T);
+  for (int t=0; t<T; ++t)
+    texts[t] = new string();
+  vector<int>    owners(ROUND);
+  vector<size_t> starts(ROUND), sizes(ROUND), offsets(ROUND);
+  size_t C = ceilDiv(N, CHUNK);
+  bool failed = false;
+  for (size_t c=0; c<C && !failed; c+=ROUND) {
+    size_t R = min(c+ROUND, C) - c;
+    for (int t=0; t<T; ++t)
+      texts[t]->clear();
+    // Format chunks of items into per-thread buffers.
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (size_t r=0; r<R; ++r) {
+      int t = omp_get_thread_num();
+      string& b = *texts[t];
+      size_t  i = (c+r) * CHUNK;
+      size_t  I = min(i + CHUNK, N);
+      owners[r] = t;
+      starts[r] = b.size();
+      for (; i<I; ++i)
+        fw(b, i);
+      sizes[r] = b.size() - starts[r];
+    }
+    // Find the position of each chunk, and extend the file to fit.
+    size_t bytes = exclusiveScanW(offsets.data(), sizes.data(), R);
+    if (ftruncate(fd, off_t(o + bytes))<0) { failed = true; break; }
+    // Write chunks at their positions, using multiple threads.
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (size_t r=0; r<R; ++r) {
+      const char *data = texts[owners[r]]->data() + starts[r];
+      if (writeBytesAt(fd, data, sizes[r], o + offsets[r])) continue;
+      #pragma omp atomic write
+      failed = true;
+    }
+    o += bytes;
+  }
+  // Free text buffers.
+  for (int t=0; t<T; ++t)
+    delete texts[t];
+  if (failed) throw runtime_error("Failed to write file");
+  return o;
+}
+
+
+/**
+ * Write text to a file, using a function that writes it at a position.
+ * @param pth file path
+ * @param fw write text (file descriptor, byte offset)
+ * @throws runtime_error if file could not be created or written
+ */
+template <class FW>
+inline void writeTextFileOmp(const char *pth, FW fw) {
+  int fd = createFileW(pth);
+  try { fw(fd, size_t()); }
+  catch (...) { ::close(fd); throw; }
+  ::close(fd);
+}
+#endif
+#pragma endregion
+
+
+
+
 #pragma region WRITE EDGELIST FORMAT
 /**
  * Write a graph in Edgelist format.
@@ -447,18 +1243,14 @@ inline void writeGraphEdgelistFormatOmp(ostream& stream, const G& x, bool weight
     for (size_t u=i*CHUNK; u<U; ++u) {
       if (!x.hasVertex(u)) continue;
       int t = omp_get_thread_num();
-      string ustr, vstr, wstr;
       x.forEachEdge(u, [&](auto v, auto w) {
         if (symmetric && u>v) return;
-        ustr = to_string(u);
-        vstr = to_string(v);
-        wstr = weighted? to_string(w) : "";
-        texts[t]->append(ustr);
+        formatNumberU(*texts[t], u);
         texts[t]->push_back(sep);
-        texts[t]->append(vstr);
+        formatNumberU(*texts[t], v);
         if (weighted) {
           texts[t]->push_back(sep);
-          texts[t]->append(wstr);
+          formatNumberU(*texts[t], w);
         }
         texts[t]->push_back('\n');
       });
@@ -471,6 +1263,52 @@ inline void writeGraphEdgelistFormatOmp(ostream& stream, const G& x, bool weight
   for (int t=0; t<T; ++t)
     if (texts[t]) delete texts[t];
 }
+
+
+/**
+ * Write a graph in Edgelist format, at a position in a file.
+ * @param fd file descriptor
+ * @param o byte offset in file
+ * @param x input graph
+ * @param weighted is graph weighted? [false]
+ * @param symmetric is graph symmetric? [false]
+ * @param sep separator [' ']
+ * @returns byte offset in file, after the written graph
+ */
+template <class G>
+inline size_t writeGraphEdgelistFormatAtOmp(int fd, size_t o, const G& x, bool weighted=false, bool symmetric=false, char sep=' ') {
+  using K = typename G::key_type;
+  auto fw = [&](string& a, size_t u) {
+    if (!x.hasVertex(K(u))) return;
+    x.forEachEdge(K(u), [&](auto v, auto w) {
+      if (symmetric && u>v) return;
+      formatNumberU(a, u);
+      a.push_back(sep);
+      formatNumberU(a, v);
+      if (weighted) {
+        a.push_back(sep);
+        formatNumberU(a, w);
+      }
+      a.push_back('\n');
+    });
+  };
+  return writeTextOmpW(fd, o, x.span(), fw);
+}
+
+
+/**
+ * Write a graph in Edgelist format.
+ * @param pth file path
+ * @param x input graph
+ * @param weighted is graph weighted? [false]
+ * @param symmetric is graph symmetric? [false]
+ * @param sep separator [' ']
+ */
+template <class G>
+inline void writeGraphEdgelistFormatOmp(const char *pth, const G& x, bool weighted=false, bool symmetric=false, char sep=' ') {
+  auto fw = [&](int fd, size_t o) { writeGraphEdgelistFormatAtOmp(fd, o, x, weighted, symmetric, sep); };
+  writeTextFileOmp(pth, fw);
+}
 #endif
 #pragma endregion
 
@@ -509,6 +1347,26 @@ inline void writeGraphCooFormatOmp(ostream& stream, const G& x, bool weighted=fa
   stream << n << ' ' << n << ' ' << m << '\n';
   writeGraphEdgelistFormatOmp(stream, x, weighted, symmetric, sep);
 }
+
+
+/**
+ * Write a graph in COO format.
+ * @param pth file path
+ * @param x input graph
+ * @param weighted is graph weighted? [false]
+ * @param symmetric is graph symmetric? [false]
+ * @param sep separator [' ']
+ */
+template <class G>
+inline void writeGraphCooFormatOmp(const char *pth, const G& x, bool weighted=false, bool symmetric=false, char sep=' ') {
+  size_t n = graphOrder(x), m = graphSizeOmp(x, !symmetric);
+  string head = to_string(n) + ' ' + to_string(n) + ' ' + to_string(m) + '\n';
+  auto fw = [&](int fd, size_t o) {
+    if (!writeBytesAt(fd, head.data(), head.size(), o)) throw runtime_error(string("Failed to write file: ") + pth);
+    writeGraphEdgelistFormatAtOmp(fd, o + head.size(), x, weighted, symmetric, sep);
+  };
+  writeTextFileOmp(pth, fw);
+}
 #endif
 #pragma endregion
 
@@ -553,6 +1411,29 @@ inline void writeGraphMtxFormatOmp(ostream& stream, const G& x, bool weighted=fa
   stream << n << ' ' << n << ' ' << m << '\n';
   writeGraphEdgelistFormatOmp(stream, x, weighted, symmetric, sep);
 }
+
+
+/**
+ * Write a graph in MTX format.
+ * @param pth file path
+ * @param x input graph
+ * @param weighted is graph weighted? [false]
+ * @param symmetric is graph symmetric? [false]
+ * @param sep separator [' ']
+ */
+template <class G>
+inline void writeGraphMtxFormatOmp(const char *pth, const G& x, bool weighted=false, bool symmetric=false, char sep=' ') {
+  size_t n = graphOrder(x), m = graphSizeOmp(x, !symmetric);
+  string head = "%%MatrixMarket matrix coordinate";
+  head += weighted?  " real"      : " pattern";
+  head += symmetric? " symmetric" : " general";
+  head += '\n' + to_string(n) + ' ' + to_string(n) + ' ' + to_string(m) + '\n';
+  auto fw = [&](int fd, size_t o) {
+    if (!writeBytesAt(fd, head.data(), head.size(), o)) throw runtime_error(string("Failed to write file: ") + pth);
+    writeGraphEdgelistFormatAtOmp(fd, o + head.size(), x, weighted, symmetric, sep);
+  };
+  writeTextFileOmp(pth, fw);
+}
 #endif
 #pragma endregion
 
@@ -581,5 +1462,46 @@ inline void writeGraphAdjFormat(ostream& stream, const G& x) {
     });
   });
 }
+
+
+#ifdef OPENMP
+/**
+ * Write a graph in adjacency graph format.
+ * @param pth file path
+ * @param x input graph
+ */
+template <class G>
+inline void writeGraphAdjFormatOmp(const char *pth, const G& x) {
+  using K = typename G::key_type;
+  size_t S = x.span();
+  size_t n = graphOrder(x), m = graphSizeOmp(x);
+  // Obtain the offset of the edges of each vertex.
+  vector<size_t> degrees(S), offsets(S), buf(omp_get_max_threads());
+  #pragma omp parallel for schedule(dynamic, 2048)
+  for (size_t u=0; u<S; ++u)
+    degrees[u] = x.hasVertex(K(u))? x.degree(K(u)) : 0;
+  exclusiveScanOmpW(offsets.data(), buf.data(), degrees.data(), S);
+  // Write header, offsets, and edges.
+  string head = "AdjacencyGraph\n" + to_string(n) + '\n' + to_string(m) + '\n';
+  auto fo = [&](string& a, size_t u) {
+    if (!x.hasVertex(K(u))) return;
+    formatNumberU(a, offsets[u]);
+    a.push_back('\n');
+  };
+  auto fe = [&](string& a, size_t u) {
+    if (!x.hasVertex(K(u))) return;
+    x.forEachEdgeKey(K(u), [&](auto v) {
+      formatNumberU(a, v);
+      a.push_back('\n');
+    });
+  };
+  auto fw = [&](int fd, size_t o) {
+    if (!writeBytesAt(fd, head.data(), head.size(), o)) throw runtime_error(string("Failed to write file: ") + pth);
+    o = writeTextOmpW(fd, o + head.size(), S, fo);
+    o = writeTextOmpW(fd, o, S, fe);
+  };
+  writeTextFileOmp(pth, fw);
+}
+#endif
 #pragma endregion
 #pragma endregion
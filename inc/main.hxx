@@ -13,5 +13,10 @@
 #include "selfLoop.hxx"
 #include "properties.hxx"
 #include "bfs.hxx"
+#include "components.hxx"
+#include "generate.hxx"
+#include "reorder.hxx"
 #include "dfs.hxx"
 #include "batch.hxx"
+#include "stream.hxx"
+#include "benchmark.hxx"
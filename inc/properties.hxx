@@ -8,6 +8,7 @@
 #include "_main.hxx"
 #include "bfs.hxx"
 #include "dfs.hxx"
+#include "components.hxx"
 #ifdef OPENMP
 #include <omp.h>
 #endif
@@ -423,32 +424,30 @@ inline vector<K> communities(const G& x, const vector<K>& vcom) {
 #pragma region DISCONNECTED COMMUNITIES
 #ifdef OPENMP
 /**
- * Examine if each community in a graph is disconnected (using single flag vector, BFS).
- * @param x given graph
+ * Examine if each community in a graph is disconnected (using connected components).
+ * @param x given graph (symmetric)
  * @param vcom community each vertex belongs to
  * @returns whether each community is disconnected
+ * @note Components are found in a single pass, following only edges within
+ * communities. A community is then disconnected if its vertices lie in more
+ * than one component.
  */
 template <class G, class K>
 inline vector<char> communitiesDisconnectedOmp(const G& x, const vector<K>& vcom) {
-  size_t  S = x.span();
-  int     T = omp_get_max_threads();
-  auto coms = communitySizeOmp(x, vcom);
-  vector<char> a(S), vis(S);
-  vector2d<K>  us (T), vs(T);
-  #pragma omp parallel
-  {
-    for (K u=0; u<S; ++u) {
-      if (!x.hasVertex(u)) continue;
-      int t = omp_get_thread_num();
-      K   c = vcom[u], reached = K();
-      if (coms[c]==0 || !belongsOmp(c)) continue;
-      auto ft = [&](auto v, auto d) { return vcom[v]==c; };
-      auto fp = [&](auto v, auto d) { ++reached; };
-      us[t].clear(); vs[t].clear(); us[t].push_back(u);
-      bfsVisitedForEachU(vis, us[t], vs[t], x, ft, fp);
-      if (reached < coms[c]) a[c] = 1;
-      coms[c] = 0;
-    }
+  const K EMPTY = K(-1);
+  size_t S = x.span();
+  auto fe = [&](auto u, auto v) { return vcom[u]==vcom[v]; };
+  auto comp = componentsAfforestOmp(x, fe);
+  vector<char> a(S);
+  vector<K> roots(S, EMPTY);
+  #pragma omp parallel for schedule(static, 2048)
+  for (size_t u=0; u<S; ++u) {
+    if (!x.hasVertex(K(u))) continue;
+    K c = vcom[u], r = comp[u];
+    if (roots[c]==r || atomicCompareExchange(roots[c], EMPTY, r)) continue;
+    if (roots[c]==r) continue;
+    #pragma omp atomic write
+    a[c] = 1;
   }
   return a;
 }
@@ -0,0 +1,366 @@
+#pragma once
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include "_main.hxx"
+#include "Graph.hxx"
+#include "csr.hxx"
+#include "bfs.hxx"
+#ifdef OPENMP
+#include <omp.h>
+#endif
+
+using std::vector;
+using std::min;
+using std::max;
+using std::sort;
+using std::reverse;
+using std::inplace_merge;
+using std::log2;
+using std::is_same;
+
+
+
+
+#pragma region METHODS
+#pragma region SORT
+#ifdef OPENMP
+/**
+ * Sort a range of values in parallel.
+ * @param ib begin iterator (updated)
+ * @param ie end iterator (updated)
+ * @param fl less than function (x, y)
+ * @note Each thread sorts a chunk, and chunks are then merged pairwise.
+ */
+template <class I, class FL>
+inline void sortOmpU(I ib, I ie, FL fl) {
+  const size_t CHUNK = 65536;
+  size_t N = ie - ib;
+  size_t H = omp_get_max_threads();
+  if (H<=1 || N<=CHUNK) { sort(ib, ie, fl); return; }
+  size_t C = (N + H-1) / H;
+  #pragma omp parallel for schedule(static, 1)
+  for (size_t i=0; i<N; i+=C)
+    sort(ib+i, ib+min(i+C, N), fl);
+  for (size_t c=C; c<N; c*=2) {
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (size_t i=0; i<N; i+=2*c)
+      inplace_merge(ib+i, ib+min(i+c, N), ib+min(i+2*c, N), fl);
+  }
+}
+#endif
+#pragma endregion
+
+
+
+
+#pragma region ORDER
+/**
+ * Obtain the vertices of a graph, in increasing order of id.
+ * @param x original graph
+ * @returns vertices of the graph
+ */
+template <class G>
+inline auto existingVertices(const G& x) {
+  using K = typename G::key_type;
+  vector<K> a;
+  a.reserve(x.order());
+  x.forEachVertexKey([&](auto u) { a.push_back(u); });
+  return a;
+}
+
+
+#ifdef OPENMP
+/**
+ * Order the vertices of a graph by decreasing degree.
+ * @param x original graph
+ * @returns vertices in new order (ties broken by id)
+ */
+template <class G>
+inline auto degreeOrderOmp(const G& x) {
+  using K = typename G::key_type;
+  auto fl = [&](K u, K v) {
+    size_t du = x.degree(u), dv = x.degree(v);
+    return du > dv || (du == dv && u < v);
+  };
+  auto a = existingVertices(x);
+  sortOmpU(a.begin(), a.end(), fl);
+  return a;
+}
+
+
+/**
+ * Order the vertices reachable from a frontier by Cuthill–McKee, using multiple threads.
+ * @param a vertices in new order, ending with the frontier (updated)
+ * @param vis vertex visited flags (updated)
+ * @param depth depth of each vertex (scratch, all zero)
+ * @param par earliest parent of each vertex (scratch, all -1)
+ * @param fb beginning of the frontier in a
+ * @param x original graph
+ * @param fl less than function, for vertices of a level, using par (u, v)
+ * @param symmetric is the graph symmetric?
+ * @note The depth of each vertex from the frontier is found with the
+ * direction-optimizing BFS (see bfsVisitedForEachOmpU()). Then, level by
+ * level, each vertex is claimed by its earliest parent in the previous level,
+ * with an atomic minimum, and the level is sorted by fl. Small frontiers are
+ * claimed sequentially.
+ */
+template <class G, class K, class FL>
+inline void cuthillMcKeeLevelsOmpU(vector<K>& a, vector<char>& vis, vector<K>& depth, vector<size_t>& par, size_t fb, const G& x, FL fl, bool symmetric) {
+  const size_t PARALLEL = 4096;  // Claim vertices in parallel only for frontiers at least this large
+  const int T = omp_get_max_threads();
+  // Find the depth of each vertex reachable from the frontier.
+  vector<K>   us(a.begin()+fb, a.end());
+  vector2d<K> vs, ls(T);
+  for (K u : us)
+    vis[u] = 0;
+  auto ft = [](K v, K d) { return true; };
+  auto fp = [&](K v, K d) {
+    if (d==0) return;
+    depth[v] = d;
+    ls[omp_get_thread_num()].push_back(v);
+  };
+  bfsVisitedForEachOmpU(vis, us, vs, x, ft, fp, symmetric);
+  // Group the vertices by depth.
+  size_t D = 0;
+  for (const auto& l : ls)
+    for (K v : l) D = max(D, size_t(depth[v]));
+  vector<size_t> offsets(D+2);
+  for (const auto& l : ls)
+    for (K v : l) ++offsets[depth[v]+1];
+  for (size_t d=1; d<=D+1; ++d)
+    offsets[d] += offsets[d-1];
+  vector<K> levels(offsets[D+1]);
+  for (const auto& l : ls)
+    for (K v : l) levels[offsets[depth[v]]++] = v;
+  for (size_t d=D; d>0; --d)
+    offsets[d] = offsets[d-1];
+  offsets[0] = 0;
+  // Append each level, with vertices claimed by their earliest parent.
+  for (size_t d=1, fe=a.size(); d<=D; ++d) {
+    if (fe-fb < PARALLEL) {
+      for (size_t i=fb; i<fe; ++i) {
+        x.forEachEdgeKey(a[i], [&](K v) {
+          if (depth[v]==K(d) && par[v]==size_t(-1)) par[v] = i;
+        });
+      }
+    }
+    else {
+      #pragma omp parallel for schedule(dynamic, 64)
+      for (size_t i=fb; i<fe; ++i) {
+        x.forEachEdgeKey(a[i], [&](K v) {
+          if (depth[v]!=K(d)) return;
+          size_t p = par[v];
+          while (i < p && !atomicCompareExchange(par[v], p, i))
+            p = par[v];
+        });
+      }
+    }
+    a.insert(a.end(), levels.begin()+offsets[d], levels.begin()+offsets[d+1]);
+    sortOmpU(a.begin()+fe, a.end(), fl);
+    fb = fe;
+    fe = a.size();
+  }
+  // Clear the scratch space.
+  for (K v : levels) {
+    depth[v] = K();
+    par[v]   = size_t(-1);
+  }
+}
+
+
+/**
+ * Order the vertices of a graph by BFS, or by Cuthill–McKee.
+ * @param x original graph (preferably symmetric)
+ * @param degree visit the children of each vertex in increasing order of degree? (else id)
+ * @param reversed reverse the order, i.e., reverse Cuthill–McKee? [false]
+ * @param symmetric is the graph symmetric? (allows bottom-up BFS steps) [false]
+ * @returns vertices in new order
+ * @note Each connected component is traversed from its unvisited vertex of
+ * lowest degree. Small components, and the small levels near the start of a
+ * component, are visited with a sequential Cuthill–McKee; once a level is
+ * large, the rest of the component is visited with cuthillMcKeeLevelsOmpU().
+ * This yields the same order as a sequential Cuthill–McKee (Karantasis et al.).
+ */
+template <class G>
+inline auto cuthillMcKeeOrderOmp(const G& x, bool degree, bool reversed=false, bool symmetric=false) {
+  using K = typename G::key_type;
+  const size_t PARALLEL = 4096;  // Switch to parallel traversal at levels at least this large
+  size_t S = x.span();
+  vector<char>   vis(S);
+  vector<K>      depth(S);
+  vector<size_t> par(S, size_t(-1));
+  vector<K> a;
+  a.reserve(x.order());
+  // Start from the vertex of lowest degree in each component.
+  auto fd = [&](K u, K v) {
+    size_t du = x.degree(u), dv = x.degree(v);
+    return du < dv || (du == dv && u < v);
+  };
+  auto fl = [&](K u, K v) {
+    if (par[u] != par[v]) return par[u] < par[v];
+    if (degree) return fd(u, v);
+    return u < v;
+  };
+  auto starts = existingVertices(x);
+  sortOmpU(starts.begin(), starts.end(), fd);
+  for (K s : starts) {
+    if (vis[s]) continue;
+    vis[s] = 1;
+    a.push_back(s);
+    // Visit the component sequentially, while its levels are small.
+    size_t i = a.size()-1, le = a.size();
+    for (; i<a.size(); ++i) {
+      if (i==le) {
+        if (a.size()-le >= PARALLEL) break;
+        le = a.size();
+      }
+      size_t ab = a.size();
+      x.forEachEdgeKey(a[i], [&](K v) {
+        if (vis[v]) return;
+        vis[v] = 1;
+        a.push_back(v);
+      });
+      sort(a.begin()+ab, a.end(), fl);
+    }
+    // Visit the rest of the component in parallel, from a large level.
+    if (i<a.size()) cuthillMcKeeLevelsOmpU(a, vis, depth, par, i, x, fl, symmetric);
+  }
+  if (reversed) reverse(a.begin(), a.end());
+  return a;
+}
+// - https://doi.org/10.1145/800195.805928
+// - https://doi.org/10.1109/SC.2014.50
+
+
+/**
+ * Order the vertices of a graph by community.
+ * @param x original graph
+ * @param vcom community of each vertex
+ * @returns vertices in new order
+ * @note Communities are placed in order of their first vertex, and vertices
+ * keep their relative order within each community.
+ */
+template <class G, class K>
+inline auto communityOrderOmp(const G& x, const vector<K>& vcom) {
+  const K EMPTY = K(-1);
+  size_t S = x.span(), C = 0;
+  for (size_t u=0; u<S; ++u)
+    if (x.hasVertex(K(u))) C = max(C, size_t(vcom[u]) + 1);
+  vector<K> first(C, EMPTY);
+  for (size_t u=0; u<S; ++u)
+    if (x.hasVertex(K(u)) && first[vcom[u]]==EMPTY) first[vcom[u]] = K(u);
+  auto fl = [&](K u, K v) {
+    K cu = first[vcom[u]], cv = first[vcom[v]];
+    return cu < cv || (cu == cv && u < v);
+  };
+  auto a = existingVertices(x);
+  sortOmpU(a.begin(), a.end(), fl);
+  return a;
+}
+
+
+/**
+ * Obtain the new id of each vertex, for a given vertex order.
+ * @param x original graph
+ * @param order vertices in new order
+ * @returns new id of each vertex (a permutation of [0, span))
+ * @note The vertices take up the same ids as before, in the new order, and
+ * ids of missing vertices are left unchanged.
+ */
+template <class G, class K>
+inline vector<K> reorderIdsOmp(const G& x, const vector<K>& order) {
+  size_t S = x.span();
+  auto slots = existingVertices(x);
+  vector<K> a(S);
+  #pragma omp parallel for schedule(static, 2048)
+  for (size_t u=0; u<S; ++u)
+    a[u] = K(u);
+  #pragma omp parallel for schedule(static, 2048)
+  for (size_t i=0; i<order.size(); ++i)
+    a[order[i]] = slots[i];
+  return a;
+}
+#endif
+#pragma endregion
+
+
+
+
+#pragma region RELABEL
+#ifdef OPENMP
+/**
+ * Relabel the vertices of a graph, into a CSR graph.
+ * @param a output csr graph (output)
+ * @param x original graph
+ * @param ids new id of each vertex (a permutation of [0, span))
+ */
+template <class H, class G, class K>
+inline void relabelCsrOmpW(H& a, const G& x, const vector<K>& ids) {
+  using E = typename H::edge_value_type;
+  size_t S = x.span();
+  a.clear();
+  a.resize(S);
+  // Move the existence and degree of each vertex.
+  #pragma omp parallel for schedule(static, 2048)
+  for (size_t u=0; u<S; ++u) {
+    a.exists[ids[u]]  = x.hasVertex(K(u));
+    a.degrees[ids[u]] = x.hasVertex(K(u))? K(x.degree(K(u))) : K();
+  }
+  // Obtain the offsets, and allocate space for the edges.
+  vector<typename H::offset_type> buf(omp_get_max_threads());
+  auto M = exclusiveScanOmpW(a.offsets.data(), buf.data(), a.degrees.data(), S);
+  a.offsets[S] = M;
+  a.edgeKeys.resize(M);
+  if constexpr (!is_same<E, None>::value) a.edgeValues.resize(M);
+  // Copy the edges, with new ids, and sort them.
+  #pragma omp parallel for schedule(dynamic, 2048)
+  for (size_t u=0; u<S; ++u) {
+    if (!x.hasVertex(K(u))) continue;
+    size_t i = a.offsets[ids[u]];
+    x.forEachEdge(K(u), [&](auto v, auto w) {
+      a.edgeKeys[i] = ids[v];
+      if constexpr (!is_same<E, None>::value) a.edgeValues[i] = E(w);
+      ++i;
+    });
+  }
+  csrSortEdgesOmpU(a.degrees, a.edgeKeys, a.edgeValues, a.offsets);
+  a.N = x.order();
+}
+#endif
+#pragma endregion
+
+
+
+
+#pragma region LOCALITY
+#ifdef OPENMP
+/**
+ * Find the average log gap of the edges of a graph.
+ * @param x original graph (edges of each vertex sorted)
+ * @returns average of log2(1 + |v - p|) over all edges, where p is the previous target of the same source (or the source itself)
+ * @note This is roughly the number of bits per edge in a gap-encoded graph;
+ * lower is better for locality (Dhulipala et al.).
+ */
+template <class G>
+inline double averageLogGapOmp(const G& x) {
+  using K = typename G::key_type;
+  size_t S = x.span(), M = 0;
+  double a = 0;
+  #pragma omp parallel for schedule(dynamic, 2048) reduction(+:a,M)
+  for (size_t u=0; u<S; ++u) {
+    if (!x.hasVertex(K(u))) continue;
+    K p = K(u);
+    x.forEachEdgeKey(K(u), [&](K v) {
+      a += log2(1.0 + double(v>p? v-p : p-v));
+      p  = v;
+      ++M;
+    });
+  }
+  return M? a/M : 0;
+}
+// - https://doi.org/10.1145/2939672.2939862
+#endif
+#pragma endregion
+#pragma endregion
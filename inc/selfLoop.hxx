@@ -70,17 +70,29 @@ inline G addSelfLoops(const G& x, E w, FT ft) {
 
 #ifdef OPENMP
 /**
- * Add self-loops to a graph in parallel.
- * @param a graph to add self-loops to (updated)
+ * Add self-loops to a graph in parallel, without updating it.
+ * @param a graph to add self-loops to (updated, call updateOmpU() to reflect the changes)
  * @param w edge weight of self-loops
  * @param ft test function to determine if self-loop should be added (vertex)
  */
 template <class G, class E, class FT>
-inline void addSelfLoopsOmpU(G& a, E w, FT ft) {
+inline void addSelfLoopsLazyOmpU(G& a, E w, FT ft) {
   #pragma omp parallel
   {
     a.forEachVertexKey([&](auto u) { if (ft(u)) addEdgeOmpU(a, u, u, w); });
   }
+}
+
+
+/**
+ * Add self-loops to a graph in parallel.
+ * @param a graph to add self-loops to (updated)
+ * @param w edge weight of self-loops
+ * @param ft test function to determine if self-loop should be added (vertex)
+ */
+template <class G, class E, class FT>
+inline void addSelfLoopsOmpU(G& a, E w, FT ft) {
+  addSelfLoopsLazyOmpU(a, w, ft);
   updateOmpU(a);
 }
 
@@ -98,4 +110,48 @@ inline G addSelfLoopsOmp(const G& x, E w, FT ft) {
 }
 #endif
 #pragma endregion
+
+
+
+
+#pragma region REMOVE SELF-LOOPS
+/**
+ * Remove self-loops from a graph.
+ * @param a graph to remove self-loops from (updated)
+ * @param ft test function to determine if self-loop should be removed (vertex)
+ */
+template <class G, class FT>
+inline void removeSelfLoopsU(G& a, FT ft) {
+  a.forEachVertexKey([&](auto u) { if (ft(u)) a.removeEdge(u, u); });
+  a.update();
+}
+
+
+#ifdef OPENMP
+/**
+ * Remove self-loops from a graph in parallel, without updating it.
+ * @param a graph to remove self-loops from (updated, call updateOmpU() to reflect the changes)
+ * @param ft test function to determine if self-loop should be removed (vertex)
+ */
+template <class G, class FT>
+inline void removeSelfLoopsLazyOmpU(G& a, FT ft) {
+  #pragma omp parallel
+  {
+    a.forEachVertexKey([&](auto u) { if (ft(u)) removeEdgeOmpU(a, u, u); });
+  }
+}
+
+
+/**
+ * Remove self-loops from a graph in parallel.
+ * @param a graph to remove self-loops from (updated)
+ * @param ft test function to determine if self-loop should be removed (vertex)
+ */
+template <class G, class FT>
+inline void removeSelfLoopsOmpU(G& a, FT ft) {
+  removeSelfLoopsLazyOmpU(a, ft);
+  updateOmpU(a);
+}
+#endif
+#pragma endregion
 #pragma endregion
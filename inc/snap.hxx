@@ -1,6 +1,7 @@
 #pragma once
 #include <utility>
 #include <string>
+#include <string_view>
 #include <istream>
 #include <sstream>
 #include <fstream>
@@ -9,12 +10,14 @@
 #include "_main.hxx"
 #include "Graph.hxx"
 #include "update.hxx"
+#include "io.hxx"
 #ifdef OPENMP
 #include <omp.h>
 #endif
 
 using std::tuple;
 using std::string;
+using std::string_view;
 using std::istream;
 using std::istringstream;
 using std::ifstream;
@@ -61,51 +64,54 @@ inline void readTemporalDo(const char *pth, bool weighted, bool symmetric, size_
 #ifdef OPENMP
 /**
  * Read contents of SNAP Temporal file.
- * @param s input stream
+ * @param data file contents (memory mapped)
  * @param weighted is it weighted?
  * @param symmetric is it symmetric?
  * @param rows number of rows/vertices
  * @param size number of lines/edges to read
- * @param fb on body line (u, v, w)
+ * @param fb on body line (u, v, w), called from the thread that owns u (see belongsOmp())
+ * @returns number of bytes read, i.e., offset of the next batch of lines
+ */
+template <class FB>
+inline size_t readTemporalDoOmp(string_view data, bool weighted, bool symmetric, size_t rows, size_t size, FB fb) {
+  if (rows==0 || size==0) return 0;
+  // Find the end of the last line to read.
+  const char *ib = data.data();
+  const char *ie = ib + data.size();
+  const char *it = ib;
+  for (; size>0 && it<ie; --size)
+    it = findNextLine(it, ie);
+  // Process body lines in parallel (zero weights are taken as 1).
+  auto fw = [&](auto u, auto v, auto w) { fb(u, v, w? w : 1); };
+  readEdgelistFormatDoOmp(string_view(ib, it-ib), weighted, symmetric, fw);
+  return it - ib;
+}
+
+
+/**
+ * Read contents of SNAP Temporal file.
+ * @param s input stream (advanced past the lines read)
+ * @param weighted is it weighted?
+ * @param symmetric is it symmetric?
+ * @param rows number of rows/vertices
+ * @param size number of lines/edges to read
+ * @param fb on body line (u, v, w), called from the thread that owns u (see belongsOmp())
+ * @note The lines are read from the stream into a buffer, and parsed in parallel.
  */
 template <class FB>
 inline void readTemporalDoOmp(istream& s, bool weighted, bool symmetric, size_t rows, size_t size, FB fb) {
   if (rows==0 || size==0) return;
-  // Process body lines in parallel.
-  const int THREADS = omp_get_max_threads();
-  const int LINES   = 131072;
-  vector<string> lines(LINES);
-  vector<tuple<size_t, size_t, double>> edges(LINES);
-  while (size>0) {
-    // Read several lines from the stream.
-    int READ = 0;
-    for (int i=0; size>0 && i<LINES; ++i, ++READ, --size)
-      if (!getline(s, lines[i])) break;
-    if (READ==0) break;
-    // Parse lines using multiple threads.
-    #pragma omp parallel for schedule(dynamic, 1024)
-    for (int i=0; i<READ; ++i) {
-      char *line = (char*) lines[i].c_str();
-      size_t u = strtoull(line, &line, 10);
-      size_t v = strtoull(line, &line, 10);
-      double w = weighted? strtod(line, &line) : 0;
-      edges[i] = {u, v, w? w : 1};
-    }
-    // Notify parsed lines.
-    #pragma omp parallel
-    {
-      for (int i=0; i<READ; ++i) {
-        const auto& [u, v, w] = edges[i];
-        fb(u, v, w);
-        if (symmetric) fb(v, u, w);
-      }
-    }
+  string data, line;
+  for (size_t i=0; i<size && getline(s, line); ++i) {
+    data += line;
+    data += '\n';
   }
+  readTemporalDoOmp(string_view(data), weighted, symmetric, rows, size, fb);
 }
 template <class FB>
-inline void readTemporalDoOmp(const char *pth, bool weighted, FB fb) {
-  ifstream s(pth);
-  readTemporalDoOmp(s, weighted, fb);
+inline void readTemporalDoOmp(const char *pth, bool weighted, bool symmetric, size_t rows, size_t size, FB fb) {
+  MappedFile data(pth);
+  readTemporalDoOmp(data.view(), weighted, symmetric, rows, size, fb);
 }
 #endif
 #pragma endregion
@@ -146,7 +152,32 @@ inline void readTemporalIfW(G &a, const char *pth, bool weighted, bool symmetric
 /**
  * Read SNAP Temporal file as graph if test passes.
  * @param a output graph (updated)
- * @param s input stream
+ * @param data file contents (memory mapped)
+ * @param weighted is it weighted?
+ * @param symmetric is it symmetric?
+ * @param rows number of rows/vertices
+ * @param size number of lines/edges to read
+ * @param fv include vertex? (u, d)
+ * @param fe include edge? (u, v, w)
+ * @returns number of bytes read, i.e., offset of the next batch of lines
+ */
+template <class G, class FV, class FE>
+inline size_t readTemporalIfOmpW(G &a, string_view data, bool weighted, bool symmetric, size_t rows, size_t size, FV fv, FE fe) {
+  using K = typename G::key_type;
+  using V = typename G::vertex_value_type;
+  using E = typename G::edge_value_type;
+  addVerticesIfU(a, K(1), K(rows+1), V(), fv);
+  auto fb = [&](auto u, auto v, auto w) { if (fe(K(u), K(v), K(w))) addEdgeOmpU(a, K(u), K(v), E(w)); };
+  size_t n = readTemporalDoOmp(data, weighted, symmetric, rows, size, fb);
+  updateOmpU(a);
+  return n;
+}
+
+
+/**
+ * Read SNAP Temporal file as graph if test passes.
+ * @param a output graph (updated)
+ * @param s input stream (advanced past the lines read)
  * @param weighted is it weighted?
  * @param symmetric is it symmetric?
  * @param rows number of rows/vertices
@@ -166,8 +197,8 @@ inline void readTemporalIfOmpW(G &a, istream& s, bool weighted, bool symmetric,
 }
 template <class G, class FV, class FE>
 inline void readTemporalIfOmpW(G &a, const char *pth, bool weighted, bool symmetric, size_t rows, size_t size, FV fv, FE fe) {
-  ifstream s(pth);
-  readTemporalIfOmpW(a, s, weighted, symmetric, rows, size, fv, fe);
+  MappedFile data(pth);
+  readTemporalIfOmpW(a, data.view(), weighted, symmetric, rows, size, fv, fe);
 }
 #endif
 #pragma endregion
@@ -202,7 +233,25 @@ inline void readTemporalW(G& a, const char *pth, bool weighted, bool symmetric,
 /**
  * Read SNAP Temporal file as graph.
  * @param a output graph (updated)
- * @param s input stream
+ * @param data file contents (memory mapped)
+ * @param weighted is it weighted?
+ * @param symmetric is it symmetric?
+ * @param rows number of rows/vertices
+ * @param size number of lines/edges to read
+ * @returns number of bytes read, i.e., offset of the next batch of lines
+ */
+template <class G>
+inline size_t readTemporalOmpW(G& a, string_view data, bool weighted, bool symmetric, size_t rows, size_t size) {
+  auto fv = [](auto u, auto d)         { return true; };
+  auto fe = [](auto u, auto v, auto w) { return true; };
+  return readTemporalIfOmpW(a, data, weighted, symmetric, rows, size, fv, fe);
+}
+
+
+/**
+ * Read SNAP Temporal file as graph.
+ * @param a output graph (updated)
+ * @param s input stream (advanced past the lines read)
  * @param weighted is it weighted?
  * @param symmetric is it symmetric?
  * @param rows number of rows/vertices
@@ -216,8 +265,8 @@ inline void readTemporalOmpW(G& a, istream& s, bool weighted, bool symmetric, si
 }
 template <class G>
 inline void readTemporalOmpW(G& a, const char *pth, bool weighted, bool symmetric, size_t rows, size_t size) {
-  ifstream s(pth);
-  readTemporalOmpW(a, s, weighted, symmetric, rows, size);
+  MappedFile data(pth);
+  readTemporalOmpW(a, data.view(), weighted, symmetric, rows, size);
 }
 #endif
 #pragma endregion
@@ -0,0 +1,558 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <queue>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <functional>
+#include <sys/resource.h>
+#include "_main.hxx"
+#include "io.hxx"
+#ifdef OPENMP
+#include <omp.h>
+#endif
+
+using std::string;
+using std::string_view;
+using std::vector;
+using std::priority_queue;
+using std::pair;
+using std::greater;
+using std::stable_sort;
+using std::min;
+using std::max;
+using std::to_string;
+using std::runtime_error;
+
+
+
+
+#pragma region CLASSES
+/** Rank of an edge mirrored by symmetrize (existing edges win). */
+#define SPILL_MIRRORED 0
+/** Rank of an edge read from the input file. */
+#define SPILL_ORIGINAL 1
+/** Rank of an edge added after reading (wins over existing edges). */
+#define SPILL_ADDED    2
+
+
+/**
+ * An edge in a sorted run, spilled to disk by a streaming transformation.
+ * @tparam K key type (vertex id)
+ * @tparam E edge value type (edge weight)
+ */
+template <class K, class E>
+struct SpillEdge {
+  /** Source vertex id. */
+  K u;
+  /** Target vertex id. */
+  K v;
+  /** Edge weight. */
+  E w;
+  /** Rank among duplicate edges, higher wins (see SPILL_*). */
+  uint8_t rank;
+};
+
+
+/**
+ * Compare two spilled edges by (source, target, rank).
+ * @param a first edge
+ * @param b second edge
+ * @returns a < b?
+ */
+template <class K, class E>
+inline bool spillEdgeLess(const SpillEdge<K, E>& a, const SpillEdge<K, E>& b) {
+  if (a.u != b.u) return a.u < b.u;
+  if (a.v != b.v) return a.v < b.v;
+  return a.rank < b.rank;
+}
+
+
+/**
+ * Sequential reader of a spilled run, with a bounded buffer.
+ * @tparam K key type (vertex id)
+ * @tparam E edge value type (edge weight)
+ */
+template <class K, class E>
+class SpillRunReader {
+  #pragma region DATA
+  protected:
+  /** Run file. */
+  FILE *file;
+  /** Buffered edges. */
+  vector<SpillEdge<K, E>> buffer;
+  /** Index of the next buffered edge. */
+  size_t index;
+  /** Number of buffered edges. */
+  size_t count;
+  #pragma endregion
+
+
+  #pragma region METHODS
+  public:
+  /**
+   * Read the next edge from the run.
+   * @param a next edge (output)
+   * @returns true if an edge was read
+   */
+  inline bool next(SpillEdge<K, E>& a) {
+    if (index == count) {
+      index = 0;
+      count = fread(buffer.data(), sizeof(SpillEdge<K, E>), buffer.size(), file);
+      if (count == 0) return false;
+    }
+    a = buffer[index++];
+    return true;
+  }
+  #pragma endregion
+
+
+  #pragma region CONSTRUCTORS & DESTRUCTORS
+  public:
+  /**
+   * Open a spilled run for reading.
+   * @param pth run file path
+   * @param capacity number of edges to buffer
+   * @throws runtime_error if run could not be opened
+   */
+  SpillRunReader(const string& pth, size_t capacity) :
+  file(fopen(pth.c_str(), "rb")), buffer(max(capacity, size_t(1))), index(0), count(0) {
+    if (!file) throw runtime_error("Failed to open run: " + pth);
+  }
+
+  SpillRunReader(const SpillRunReader&) = delete;
+  SpillRunReader& operator=(const SpillRunReader&) = delete;
+
+  /**
+   * Close the spilled run.
+   */
+  ~SpillRunReader() {
+    if (file) fclose(file);
+  }
+  #pragma endregion
+};
+#pragma endregion
+
+
+
+
+#pragma region METHODS
+#pragma region SPILL RUN
+/**
+ * Sort a buffer of edges, and spill it to disk as a run.
+ * @param buf buffer of edges (cleared)
+ * @param pth run file path
+ * @throws runtime_error if run could not be written
+ * @note The sort is stable, so that duplicate edges stay in the order they were
+ * read, and only the winner among them (see mergeSpillRunsDo()) is spilled.
+ */
+template <class K, class E>
+inline void spillRunW(vector<SpillEdge<K, E>>& buf, const string& pth) {
+  auto fe = [](const auto& a, const auto& b) { return a.u==b.u && a.v==b.v; };
+  stable_sort(buf.begin(), buf.end(), spillEdgeLess<K, E>);
+  auto it = unique_last_copy(buf.begin(), buf.end(), buf.begin(), fe);
+  buf.erase(it, buf.end());
+  FILE *file = fopen(pth.c_str(), "wb");
+  if (!file) throw runtime_error("Failed to create run: " + pth);
+  size_t N = fwrite(buf.data(), sizeof(SpillEdge<K, E>), buf.size(), file);
+  bool failed = fclose(file)!=0 || N!=buf.size();
+  if (failed) throw runtime_error("Failed to write run: " + pth);
+  buf.clear();
+}
+
+
+/**
+ * Remove spilled runs from disk.
+ * @param runs run file paths (cleared)
+ */
+inline void removeRunsW(vector<string>& runs) {
+  for (const string& pth : runs)
+    remove(pth.c_str());
+  runs.clear();
+}
+
+
+/**
+ * Get the number of runs that can be merged at once, in bounded memory.
+ * @param memory approximate memory to use, in bytes
+ * @returns maximum fan-in of a merge (at least 2)
+ * @note Each run needs an open file, and a buffer of at least 4 KiB (half the
+ * memory is left for the output). A few files are kept free for the input,
+ * output, and standard streams.
+ */
+inline size_t spillFanIn(size_t memory) {
+  const size_t BUFFER   = 4096;
+  const size_t RESERVED = 16;
+  size_t F = memory/2 / BUFFER;
+  rlimit rl;
+  if (getrlimit(RLIMIT_NOFILE, &rl)==0 && rl.rlim_cur!=RLIM_INFINITY)
+    F = min(F, rl.rlim_cur>RESERVED? size_t(rl.rlim_cur - RESERVED) : size_t());
+  return max(F, size_t(2));
+}
+#pragma endregion
+
+
+
+
+#pragma region READ SPILL RUNS
+#ifdef OPENMP
+/**
+ * Read a file in Edgelist format into sorted runs on disk, in bounded memory.
+ * @param runs run file paths, in merge order (output)
+ * @param exists which vertices exist (updated)
+ * @param data file contents (memory mapped, without header)
+ * @param prefix path prefix for run files
+ * @param weighted is graph weighted?
+ * @param symmetric is graph symmetric?
+ * @param symmetrize add reverse edges (v, u) that are missing?
+ * @param memory approximate memory to use, in bytes
+ * @note Edges are buffered by the thread that owns their source vertex, and
+ * each full buffer is sorted and spilled as a run. Duplicates of an edge (with
+ * the same rank) are thus buffered by the same thread, and its runs are listed
+ * in the order they were spilled, so that the last edge read among duplicates
+ * can be found again when merging.
+ * @note Half the memory holds the spill buffers of all threads, along with as
+ * much again for sorting them. The other half holds a block of the input, and
+ * the edges parsed from it (assuming lines as short as "u v"); pages of each
+ * block are released once parsed. The existence flags (a bit per vertex), and
+ * a few counters per thread, are not included.
+ */
+template <class K, class E>
+inline void readSpillRunsOmpW(vector<string>& runs, vector<bool>& exists, string_view data, const string& prefix, bool weighted, bool symmetric, bool symmetrize, size_t memory) {
+  using EDGE = SpillEdge<K, E>;
+  using PARSED = tuple<size_t, size_t, double>;
+  // Shortest line, and bytes used to parse it (edge, bucket entries, target).
+  const size_t LINE  = 4;
+  const size_t PARSE = 3 * sizeof(PARSED) + sizeof(size_t);
+  const int    T     = omp_get_max_threads();
+  const size_t BLOCK = max(memory/2 / (1 + PARSE/LINE), size_t(4096));
+  const size_t LIMIT = max(memory/2 / (2 * T * sizeof(EDGE)), size_t(256));
+  vector2d<EDGE>   bufs(T);
+  vector2d<string> paths(T);
+  vector<int>      errors(T);
+  const char *rb = data.data();
+  // Add an edge to the buffer of the current thread, spilling it when full.
+  auto fa = [&](int t, size_t u, size_t v, double w, uint8_t rank) {
+    vector<EDGE>& b = bufs[t];
+    b.push_back({K(u), K(v), E(w), rank});
+    if (b.size() < LIMIT || errors[t]) return;
+    paths[t].push_back(prefix + ".run" + to_string(t) + "." + to_string(paths[t].size()));
+    try { spillRunW(b, paths[t].back()); }
+    catch (const runtime_error&) { errors[t] = 1; }
+  };
+  // Release pages of the input that have been parsed.
+  auto fs = [&](size_t S, size_t n) {
+    if (S > exists.size()) exists.resize(S);
+    const char *ie = data.data() + n;
+    rb = adviseMemory(rb, ie - rb, MADV_DONTNEED);
+  };
+  auto fv = [&](size_t u) { exists[u] = true; };  // owners write disjoint words (see ownerOmp())
+  auto fb = [&](size_t u, size_t v, double w) {
+    int t = omp_get_thread_num();
+    fa(t, u, v, w, SPILL_ORIGINAL);
+    if (symmetrize && u!=v) fa(t, v, u, w, SPILL_MIRRORED);
+  };
+  for (int t=0; t<T; ++t)
+    bufs[t].reserve(LIMIT);
+  readEdgelistFormatDoOmp(data, weighted, symmetric, fs, fv, fb, BLOCK);
+  // Spill the remaining edges.
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (int t=0; t<T; ++t) {
+    if (!bufs[t].empty() && !errors[t]) {
+      paths[t].push_back(prefix + ".run" + to_string(t) + "." + to_string(paths[t].size()));
+      try { spillRunW(bufs[t], paths[t].back()); }
+      catch (const runtime_error&) { errors[t] = 1; }
+    }
+    vector<EDGE>().swap(bufs[t]);
+  }
+  runs.clear();
+  for (int t=0; t<T; ++t)
+    runs.insert(runs.end(), paths[t].begin(), paths[t].end());
+  for (int t=0; t<T; ++t)
+    if (errors[t]) { removeRunsW(runs); throw runtime_error("Failed to write run: " + prefix); }
+}
+#endif
+#pragma endregion
+
+
+
+
+#pragma region MERGE SPILL RUNS
+/**
+ * Merge sorted runs, and call a function on each unique spilled edge, in order.
+ * @param runs run file paths, in merge order
+ * @param exists which vertices exist
+ * @param selfLoops add a self-loop (u, u, 1) to each vertex?
+ * @param memory approximate memory to use, in bytes (for run buffers)
+ * @param fe on unique edge (spilled edge), in order of (u, v)
+ * @note Among duplicate edges, the one of highest rank wins, and then the one
+ * read last, as with updateU(). Added self-loops win over existing ones.
+ */
+template <class K, class E, class FE>
+inline void mergeSpillRunEdgesDo(const vector<string>& runs, const vector<bool>& exists, bool selfLoops, size_t memory, FE fe) {
+  using EDGE  = SpillEdge<K, E>;
+  using ENTRY = pair<EDGE, size_t>;
+  size_t R = runs.size();
+  size_t C = max(memory / (max(R, size_t(1)) * sizeof(EDGE)), size_t(256));
+  vector<SpillRunReader<K, E>*> readers(R);
+  size_t su = 0;
+  // Read the next edge from a run, or the next self-loop (r == R).
+  auto fn = [&](EDGE& a, size_t r) {
+    if (r<R) return readers[r]->next(a);
+    while (su<exists.size() && !exists[su]) ++su;
+    if (su>=exists.size()) return false;
+    a = {K(su), K(su), E(1), uint8_t(SPILL_ADDED)};
+    ++su;
+    return true;
+  };
+  auto fl = [](const ENTRY& a, const ENTRY& b) {
+    if (spillEdgeLess(b.first, a.first)) return true;
+    if (spillEdgeLess(a.first, b.first)) return false;
+    return a.second > b.second;
+  };
+  priority_queue<ENTRY, vector<ENTRY>, decltype(fl)> heap(fl);
+  try {
+    for (size_t r=0; r<R; ++r)
+      readers[r] = new SpillRunReader<K, E>(runs[r], C);
+    for (size_t r=0; r<R+size_t(selfLoops); ++r) {
+      EDGE a;
+      if (fn(a, r)) heap.push({a, r});
+    }
+    // Call the function on the last of each group of duplicates.
+    EDGE e; bool has = false;
+    while (!heap.empty()) {
+      ENTRY x = heap.top(); heap.pop();
+      if (has && (x.first.u!=e.u || x.first.v!=e.v)) fe(e);
+      e = x.first; has = true;
+      if (fn(x.first, x.second)) heap.push(x);
+    }
+    if (has) fe(e);
+  }
+  catch (...) {
+    for (size_t r=0; r<R; ++r)
+      delete readers[r];
+    throw;
+  }
+  for (size_t r=0; r<R; ++r)
+    delete readers[r];
+}
+
+
+/**
+ * Merge sorted runs, and call a function on each unique edge, in order.
+ * @param runs run file paths, in merge order (at most spillFanIn(memory))
+ * @param exists which vertices exist
+ * @param selfLoops add a self-loop (u, u, 1) to each vertex?
+ * @param memory approximate memory to use, in bytes (for run buffers)
+ * @param fe on unique edge (u, v, w), in order of (u, v)
+ * @note Among duplicate edges, the one of highest rank wins, and then the one
+ * read last, as with updateU(). Added self-loops win over existing ones.
+ */
+template <class K, class E, class FE>
+inline void mergeSpillRunsDo(const vector<string>& runs, const vector<bool>& exists, bool selfLoops, size_t memory, FE fe) {
+  auto fs = [&](const auto& e) { fe(e.u, e.v, e.w); };
+  mergeSpillRunEdgesDo<K, E>(runs, exists, selfLoops, memory, fs);
+}
+
+
+/**
+ * Merge sorted runs in passes, until they are few enough to be merged at once.
+ * @param runs run file paths, in merge order (updated)
+ * @param prefix path prefix for merged run files
+ * @param memory approximate memory to use, in bytes
+ * @throws runtime_error if a run could not be read or written
+ * @note Consecutive runs are merged into one (see spillFanIn()), which takes
+ * their place in the merge order, so that the same edges win among duplicates.
+ * Half the memory buffers the runs being merged, and the other half the merged
+ * run. Runs are removed once merged, and on failure runs still lists every run
+ * left on disk.
+ */
+template <class K, class E>
+inline void reduceSpillRunsW(vector<string>& runs, const string& prefix, size_t memory) {
+  using EDGE = SpillEdge<K, E>;
+  const size_t F = spillFanIn(memory);
+  const size_t C = max(memory/2 / sizeof(EDGE), size_t(256));
+  const vector<bool> none;
+  vector<EDGE> buf;
+  for (size_t pass=0; runs.size()>F; ++pass) {
+    size_t R = runs.size(), n = 0;
+    for (size_t i=0; i<R; i+=F, ++n) {
+      size_t I = min(i+F, R);
+      if (I-i==1) { runs[n] = runs[i]; continue; }
+      // Merge the group of runs into a new run, with an output buffer.
+      vector<string> group(runs.begin()+i, runs.begin()+I);
+      string pth = prefix + ".merge" + to_string(pass) + "." + to_string(n);
+      FILE *file = fopen(pth.c_str(), "wb");
+      if (!file) throw runtime_error("Failed to create run: " + pth);
+      bool failed = false;
+      auto fw = [&]() {
+        if (!failed) failed = fwrite(buf.data(), sizeof(EDGE), buf.size(), file)!=buf.size();
+        buf.clear();
+      };
+      auto fe = [&](const EDGE& e) {
+        buf.push_back(e);
+        if (buf.size()>=C) fw();
+      };
+      buf.reserve(C);
+      try { mergeSpillRunEdgesDo<K, E>(group, none, false, memory/2, fe); }
+      catch (...) { fclose(file); remove(pth.c_str()); throw; }
+      fw();
+      failed |= fclose(file)!=0;
+      if (failed) { remove(pth.c_str()); throw runtime_error("Failed to write run: " + pth); }
+      // Replace the group with the merged run.
+      for (const string& r : group)
+        remove(r.c_str());
+      runs[n] = pth;
+    }
+    runs.resize(n);
+  }
+  vector<EDGE>().swap(buf);
+}
+#pragma endregion
+
+
+
+
+#pragma region WRITE SPILL RUNS
+#ifdef OPENMP
+/**
+ * Copy the contents of a file, to a position in another file.
+ * @param fd file descriptor
+ * @param o byte offset in file
+ * @param pth source file path
+ * @param chunk number of bytes to copy at a time [0 => 1 MiB]
+ * @returns byte offset in file, after the copied contents
+ * @throws runtime_error if file could not be copied
+ */
+inline size_t copyFileAtW(int fd, size_t o, const char *pth, size_t chunk=0) {
+  const size_t CHUNK = chunk? chunk : 1024 * 1024;
+  FILE *file = fopen(pth, "rb");
+  if (!file) throw runtime_error(string("Failed to open file: ") + pth);
+  string buf(CHUNK, '\0');
+  bool failed = false;
+  while (!failed) {
+    size_t N = fread(buf.data(), 1, CHUNK, file);
+    if (N==0) { failed = ferror(file)!=0; break; }
+    failed = !writeBytesAt(fd, buf.data(), N, o);
+    o += N;
+  }
+  fclose(file);
+  if (failed) throw runtime_error(string("Failed to copy file: ") + pth);
+  return o;
+}
+
+
+/**
+ * Write the unique edges of sorted runs in Edgelist format, at a position in a file.
+ * @param fd file descriptor
+ * @param o byte offset in file
+ * @param runs run file paths, in merge order
+ * @param exists which vertices exist
+ * @param weighted is graph weighted? [false]
+ * @param symmetric is graph symmetric? [false]
+ * @param selfLoops add a self-loop (u, u, 1) to each vertex? [false]
+ * @param memory approximate memory to use, in bytes [0]
+ * @param sep separator [' ']
+ * @returns byte offset in file after the written edges, and number of edges (see graphSize())
+ * @note Half the memory buffers the runs, and the other half the formatted text.
+ */
+template <class K, class E>
+inline pair<size_t, size_t> writeSpillRunsEdgelistFormatAtW(int fd, size_t o, const vector<string>& runs, const vector<bool>& exists, bool weighted=false, bool symmetric=false, bool selfLoops=false, size_t memory=0, char sep=' ') {
+  const size_t CHUNK = memory? max(memory/2, size_t(4096)) : 1024 * 1024;
+  string buf;
+  size_t M = 0, L = 0;
+  bool failed = false;
+  buf.reserve(CHUNK + 1024);
+  auto fe = [&](auto u, auto v, auto w) {
+    ++M; if (u==v) ++L;
+    if (symmetric && u>v) return;
+    formatNumberU(buf, u);
+    buf.push_back(sep);
+    formatNumberU(buf, v);
+    if (weighted) {
+      buf.push_back(sep);
+      formatNumberU(buf, w);
+    }
+    buf.push_back('\n');
+    if (buf.size() < CHUNK || failed) return;
+    failed = !writeBytesAt(fd, buf.data(), buf.size(), o);
+    o += buf.size();
+    buf.clear();
+  };
+  mergeSpillRunsDo<K, E>(runs, exists, selfLoops, memory/2, fe);
+  if (!failed) failed = !writeBytesAt(fd, buf.data(), buf.size(), o);
+  if (failed) throw runtime_error("Failed to write file");
+  o += buf.size();
+  return {o, symmetric? (M-L)/2 : M};
+}
+
+
+/**
+ * Write the unique edges of sorted runs in Edgelist format.
+ * @param pth file path
+ * @param runs run file paths, in merge order
+ * @param exists which vertices exist
+ * @param weighted is graph weighted? [false]
+ * @param symmetric is graph symmetric? [false]
+ * @param selfLoops add a self-loop (u, u, 1) to each vertex? [false]
+ * @param memory approximate memory to use, in bytes [0]
+ * @param sep separator [' ']
+ * @returns number of edges written (see graphSize())
+ */
+template <class K, class E>
+inline size_t writeSpillRunsEdgelistFormatW(const char *pth, const vector<string>& runs, const vector<bool>& exists, bool weighted=false, bool symmetric=false, bool selfLoops=false, size_t memory=0, char sep=' ') {
+  size_t m = 0;
+  auto fw = [&](int fd, size_t o) { m = writeSpillRunsEdgelistFormatAtW<K, E>(fd, o, runs, exists, weighted, symmetric, selfLoops, memory, sep).second; };
+  writeTextFileOmp(pth, fw);
+  return m;
+}
+
+
+/**
+ * Write the unique edges of sorted runs in COO or MTX format.
+ * @param pth file path
+ * @param runs run file paths, in merge order
+ * @param exists which vertices exist
+ * @param mtx write MTX header (or COO header)?
+ * @param weighted is graph weighted? [false]
+ * @param symmetric is graph symmetric? [false]
+ * @param selfLoops add a self-loop (u, u, 1) to each vertex? [false]
+ * @param memory approximate memory to use, in bytes [0]
+ * @param sep separator [' ']
+ * @returns number of edges written (see graphSize())
+ * @note The number of edges is only known after merging, so the edges are
+ * first written to a temporary file, and then copied after the header.
+ */
+template <class K, class E>
+inline size_t writeSpillRunsCooMtxFormatW(const char *pth, const vector<string>& runs, const vector<bool>& exists, bool mtx, bool weighted=false, bool symmetric=false, bool selfLoops=false, size_t memory=0, char sep=' ') {
+  string body = string(pth) + ".body";
+  size_t n = 0, m = 0;
+  for (size_t u=0; u<exists.size(); ++u)
+    if (exists[u]) ++n;
+  string head;
+  if (mtx) {
+    head += "%%MatrixMarket matrix coordinate";
+    head += weighted?  " real"      : " pattern";
+    head += symmetric? " symmetric" : " general";
+    head += '\n';
+  }
+  auto fw = [&](int fd, size_t o) {
+    head += to_string(n) + ' ' + to_string(n) + ' ' + to_string(m) + '\n';
+    if (!writeBytesAt(fd, head.data(), head.size(), o)) throw runtime_error(string("Failed to write file: ") + pth);
+    copyFileAtW(fd, o + head.size(), body.c_str(), memory);
+  };
+  try {
+    m = writeSpillRunsEdgelistFormatW<K, E>(body.c_str(), runs, exists, weighted, symmetric, selfLoops, memory, sep);
+    writeTextFileOmp(pth, fw);
+  }
+  catch (...) { remove(body.c_str()); throw; }
+  remove(body.c_str());
+  return m;
+}
+#endif
+#pragma endregion
+#pragma endregion
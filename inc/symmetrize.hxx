@@ -37,11 +37,11 @@ inline void symmetrizeU(G& a) {
 
 #ifdef OPENMP
 /**
- * Ensure that the graph is symmetric.
- * @param a graph (updated)
+ * Add the missing reverse edges to a graph, without updating it.
+ * @param a graph (updated, call updateOmpU() to reflect the changes)
  */
 template <class G>
-inline void symmetrizeOmpU(G& a) {
+inline void symmetrizeLazyOmpU(G& a) {
   using K = typename G::key_type;
   using V = typename G::edge_value_type;
   // Obtain the list of missing edges.
@@ -65,6 +65,16 @@ inline void symmetrizeOmpU(G& a) {
         addEdgeOmpU(a, u, v, w);
     }
   }
+}
+
+
+/**
+ * Ensure that the graph is symmetric.
+ * @param a graph (updated)
+ */
+template <class G>
+inline void symmetrizeOmpU(G& a) {
+  symmetrizeLazyOmpU(a);
   updateOmpU(a);
 }
 #endif
@@ -129,13 +129,13 @@ inline void updateU(G& a) {
 template <class G>
 inline void updateOmpU(G& a) {
   using  K = typename G::key_type;
-  using  E = typename G::edge_value_type;
+  using  P = typename G::edge_entry_type;
   size_t S = a.span();
   // Create per-thread buffers for update operation.
   int THREADS = omp_get_max_threads();
-  vector<vector<pair<K, E>>*> bufs(THREADS);
+  vector<vector<P>*> bufs(THREADS);
   for (int i=0; i<THREADS; ++i)
-    bufs[i] = new vector<pair<K, E>>();
+    bufs[i] = new vector<P>();
   // Update edges of each vertex individually.
   #pragma omp parallel for schedule(dynamic, 2048)
   for (K u=0; u<S; ++u) {
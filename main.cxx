@@ -16,14 +16,6 @@ using namespace std;
 
 
 #pragma region CONFIGURATION
-#ifndef KEY_TYPE
-/** Type of vertex ids. */
-#define KEY_TYPE uint32_t
-#endif
-#ifndef EDGE_VALUE_TYPE
-/** Type of edge weights. */
-#define EDGE_VALUE_TYPE float
-#endif
 #ifndef MAX_THREADS
 /** Maximum number of threads to use. */
 #define MAX_THREADS 1
@@ -37,7 +29,153 @@ using namespace std;
 
 
 
+#pragma region GRAPH TYPES
+/**
+ * Key and edge value types to run a command with.
+ */
+struct GraphTypes {
+  /** Width of vertex ids, in bits (32 or 64). */
+  int keyBits = 32;
+  /** Type of edge weights (none, float, or double). */
+  string edgeValueType = "none";
+};
+
+
+/**
+ * Choose the key and edge value types for the specified input graph.
+ * @param file input file name (empty for none)
+ * @param format input file format
+ * @param span number of vertices, if known [0]
+ * @param weighted are edge weights needed? [false]
+ * @param precise keep edge weights in double precision? [false]
+ * @returns key and edge value types
+ * @note Vertex ids are 64-bit only if the MTX, COO, or adjacency header, or a
+ * scan of an Edgelist file, has vertex ids beyond 32 bits. Edge weights are
+ * only kept if they are written out, or are present in a binary file, which
+ * is mapped as is. Thus pattern graphs carry no edge weights at all.
+ */
+inline GraphTypes readGraphTypes(const string& file, const string& format, size_t span=0, bool weighted=false, bool precise=false) {
+  GraphTypes a;
+  bool wide = span > UINT32_MAX;
+  if (weighted) a.edgeValueType = precise? "double" : "float";
+  if (file.empty()) {}
+  else if (format=="gen") {
+    auto o = parseGenerateSpec(file);
+    if (!o.valid) throw std::runtime_error("Invalid random graph: `" + file + "`");
+    size_t N = o.vertices;
+    if (o.kind=="rmat") { N = 1; while (N < o.vertices) N *= 2; }
+    wide |= N >= UINT32_MAX;
+  }
+  else if (format=="bin") {
+    MappedFile data(file.c_str());
+    auto h = readGraphBinaryFormatHeader(data.view());
+    if (h.edgeValueBytes) a.edgeValueType = h.edgeValueBytes==sizeof(double)? "double" : "float";
+    a.keyBits = 8 * h.keyBytes;
+    return a;
+  }
+  else if (format=="mtx" || format=="coo") {
+    bool symmetric = false; size_t rows = 0, cols = 0, size = 0;
+    ifstream stream(file.c_str());
+    if (format=="mtx") readMtxFormatHeader(symmetric, rows, cols, size, stream);
+    else readCooFormatHeaderW(rows, cols, size, stream);
+    wide |= max(rows, cols) >= UINT32_MAX;
+  }
+  else if (format=="adj") {
+    string line;
+    ifstream stream(file.c_str());
+    while (getline(stream, line) && (line[0]=='#' || line=="AdjacencyGraph")) {}
+    wide |= strtoull(line.c_str(), nullptr, 10) >= UINT32_MAX;
+  }
+  else {
+    MappedFile data(file.c_str());
+    wide |= hasWideKeysEdgelistFormatOmp(data.view());
+  }
+  a.keyBits = wide? 64 : 32;
+  return a;
+}
+
+
+/**
+ * Run a function with the given key and edge value types.
+ * @param t key and edge value types
+ * @param fn function (key, edge value), called with a value of each type
+ * @returns result of the function
+ */
+template <class F>
+inline int runWithGraphTypes(const GraphTypes& t, F fn) {
+  auto fe = [&](auto k) {
+    if (t.edgeValueType=="float")  return fn(k, float());
+    if (t.edgeValueType=="double") return fn(k, double());
+    return fn(k, None());
+  };
+  if (t.keyBits==32) return fe(uint32_t());
+  if (t.keyBits==64) return fe(uint64_t());
+  throw std::runtime_error("Unsupported vertex id width: " + to_string(t.keyBits) + " bits");
+}
+#pragma endregion
+
+
+
+
 #pragma region IO
+/**
+ * Generate the edges of a random graph.
+ * @param edges lists of edges (u, v, w), one per thread (output)
+ * @param o random graph options
+ * @param weighted generate random weights? [false]
+ * @returns number of vertices (1-based vertex ids)
+ */
+template <class K, class E>
+inline size_t generateEdgesW(vector2d<tuple<K, K, E>>& edges, const OptionsGenerate& o, bool weighted=false) {
+  size_t N = o.vertices;
+  if (o.kind=="rmat") {
+    int scale = 0;
+    while ((size_t(1) << scale) < N) ++scale;
+    N = size_t(1) << scale;
+    generateRmatOmpW(edges, scale, o.edges, o.pa, o.pb, o.pc, o.seed, weighted);
+  }
+  else if (o.kind=="gnm") generateErdosRenyiGnmOmpW(edges, N, o.edges, o.seed, weighted);
+  else if (o.kind=="gnp") generateErdosRenyiGnpOmpW(edges, N, o.probability, o.seed, weighted);
+  else if (o.kind=="ba")  generateBarabasiAlbertOmpW(edges, N, o.degree, o.seed, weighted);
+  return N;
+}
+
+
+/**
+ * Generate the specified random graph, directly in CSR format.
+ * @param a generated csr graph (output)
+ * @param spec random graph specification (see parseGenerateSpec())
+ * @param weighted generate random weights? [false]
+ * @param symmetrize add reverse edges too? [false]
+ */
+template <class K, class V, class E, class O>
+inline void generateGraphW(DiGraphCsr<K, V, E, O>& a, const string& spec, bool weighted=false, bool symmetrize=false) {
+  auto o = parseGenerateSpec(spec);
+  if (!o.valid) throw std::runtime_error("Invalid random graph: `" + spec + "`");
+  vector2d<tuple<K, K, E>> edges;
+  size_t N = generateEdgesW(edges, o, weighted);
+  generateGraphCsrOmpW(a, edges, N, o.undirected || symmetrize);
+}
+
+
+/**
+ * Generate the specified random graph.
+ * @param a generated graph (output)
+ * @param spec random graph specification (see parseGenerateSpec())
+ * @param weighted generate random weights? [false]
+ */
+template <class G>
+inline void generateGraphW(G& a, const string& spec, bool weighted=false) {
+  using K = typename G::key_type;
+  using E = typename G::edge_value_type;
+  DiGraphCsr<K, None, E> x;
+  generateGraphW(x, spec, weighted);
+  auto fv = [](auto u, auto d)         { return true; };
+  auto fe = [](auto u, auto v, auto w) { return true; };
+  duplicateIfOmpW(a, x, fv, fe);
+}
+
+
 /**
  * Read the specified input graph.
  * @param a read graph (output)
@@ -48,13 +186,92 @@ using namespace std;
  */
 template <class G>
 inline void readGraphW(G& a, const string& file, const string& format, bool weighted=false, bool symmetric=false) {
-  ifstream stream(file.c_str());
-  if (format=="mtx") readGraphMtxFormatOmpW(a, stream, weighted);
-  else if (format=="coo") readGraphCooFormatOmpW(a, stream, weighted, symmetric);
-  else if (format=="edgelist" || format=="csv" || format=="tsv") readGraphEdgelistFormatOmpW(a, stream, weighted, symmetric);
-  else if (format=="adj") readGraphAdjFormatOmpW(a, stream);
+  if (format=="gen") {
+    generateGraphW(a, file, weighted);
+    return;
+  }
+  if (format=="adj") {
+    ifstream stream(file.c_str());
+    readGraphAdjFormatOmpW(a, stream);
+    return;
+  }
+  MappedFile data(file.c_str());
+  if (format=="bin") readGraphBinaryFormatOmpW(a, data.view());
+  else if (format=="mtx") readGraphMtxFormatOmpW(a, data.view(), weighted);
+  else if (format=="coo") readGraphCooFormatOmpW(a, data.view(), weighted, symmetric);
+  else if (format=="edgelist" || format=="csv" || format=="tsv") readGraphEdgelistFormatOmpW(a, data.view(), weighted, symmetric);
   else throw std::runtime_error("Unknown input format: `" + format + "`");
-  stream.close();
+}
+
+
+/**
+ * Read the specified input graph directly in CSR format (not for adj/bin).
+ * @param a read csr graph (output)
+ * @param file input file name
+ * @param format input file format
+ * @param weighted is graph weighted? [false]
+ * @param symmetric is graph symmetric? [false]
+ * @param symmetrize add reverse edges while reading? [false]
+ */
+template <class K, class V, class E, class O>
+inline void readGraphCsrW(DiGraphCsr<K, V, E, O>& a, const string& file, const string& format, bool weighted=false, bool symmetric=false, bool symmetrize=false) {
+  if (format=="gen") {
+    generateGraphW(a, file, weighted, symmetrize);
+    return;
+  }
+  MappedFile data(file.c_str());
+  if (format=="mtx") readGraphMtxFormatOmpW(a, data.view(), weighted, symmetrize);
+  else if (format=="coo") readGraphCooFormatOmpW(a, data.view(), weighted, symmetric || symmetrize);
+  else if (format=="edgelist" || format=="csv" || format=="tsv") readGraphEdgelistFormatOmpW(a, data.view(), weighted, symmetric || symmetrize);
+  else throw std::runtime_error("Unsupported CSR input format: `" + format + "`");
+}
+
+
+/**
+ * Transform the specified input graph through disk, and write the output graph.
+ * @param file input file name
+ * @param format input file format (not adj/bin)
+ * @param outputFile output file name
+ * @param outputFormat output file format (not adj/bin)
+ * @param memory approximate memory to use, in bytes
+ * @param weighted is input graph weighted? [false]
+ * @param symmetric is input graph symmetric? [false]
+ * @param outputWeighted is output graph weighted? [false]
+ * @param outputSymmetric is output graph symmetric? [false]
+ * @param symmetrize add reverse edges (v, u) that are missing? [false]
+ * @param selfLoops add a self-loop to each vertex? [false]
+ * @returns number of vertices and edges written
+ */
+template <class K, class E>
+inline pair<size_t, size_t> streamGraphW(const string& file, const string& format, const string& outputFile, const string& outputFormat, size_t memory, bool weighted=false, bool symmetric=false, bool outputWeighted=false, bool outputSymmetric=false, bool symmetrize=false, bool selfLoops=false) {
+  MappedFile data(file.c_str());
+  string_view body = data.view();
+  vector<bool>   exists;
+  vector<string> runs;
+  size_t rows = 0, cols = 0, size = 0, o = 0;
+  if (format=="mtx") o = readMtxFormatHeader(symmetric, rows, cols, size, body);
+  else if (format=="coo") o = readCooFormatHeaderW(rows, cols, size, body);
+  else if (format!="edgelist" && format!="csv" && format!="tsv") throw std::runtime_error("Unsupported streaming input format: `" + format + "`");
+  exists.resize(max(rows, cols) + 1, true);
+  exists[0] = false;
+  readSpillRunsOmpW<K, E>(runs, exists, body.substr(o), outputFile, weighted, symmetric, symmetrize && !symmetric, memory);
+  data.close();
+  size_t n = 0, m = 0;
+  for (size_t u=0; u<exists.size(); ++u)
+    if (exists[u]) ++n;
+  const char *pth = outputFile.c_str();
+  try {
+    reduceSpillRunsW<K, E>(runs, outputFile, memory);
+    if (outputFormat=="mtx") m = writeSpillRunsCooMtxFormatW<K, E>(pth, runs, exists, true, outputWeighted, outputSymmetric, selfLoops, memory);
+    else if (outputFormat=="coo") m = writeSpillRunsCooMtxFormatW<K, E>(pth, runs, exists, false, outputWeighted, outputSymmetric, selfLoops, memory);
+    else if (outputFormat=="edgelist") m = writeSpillRunsEdgelistFormatW<K, E>(pth, runs, exists, outputWeighted, outputSymmetric, selfLoops, memory);
+    else if (outputFormat=="csv") m = writeSpillRunsEdgelistFormatW<K, E>(pth, runs, exists, outputWeighted, outputSymmetric, selfLoops, memory, ',');
+    else if (outputFormat=="tsv") m = writeSpillRunsEdgelistFormatW<K, E>(pth, runs, exists, outputWeighted, outputSymmetric, selfLoops, memory, '\t');
+    else throw std::runtime_error("Unsupported streaming output format: \'" + outputFormat + "\'");
+  }
+  catch (...) { removeRunsW(runs); throw; }
+  removeRunsW(runs);
+  return {n, m};
 }
 
 
@@ -63,34 +280,74 @@ inline void readGraphW(G& a, const string& file, const string& format, bool weig
  * @param x graph to write (input)
  * @param file output file name
  * @param format output file format
+ * @param sequential write sequentially? [false]
  * @param weighted is graph weighted? [false]
  * @param symmetric is graph symmetric? [false]
  */
 template <class G>
 inline void writeGraph(const G& x, const string& file, const string& format, bool sequential=false, bool weighted=false, bool symmetric=false) {
-  ofstream stream(file.c_str());
-  if (sequential) {
-    if (format=="mtx") writeGraphMtxFormat(stream, x, weighted, symmetric);
-    else if (format=="coo") writeGraphCooFormat(stream, x, weighted, symmetric);
-    else if (format=="edgelist") writeGraphEdgelistFormat(stream, x, weighted, symmetric);
-    else if (format=="csv") writeGraphEdgelistFormat(stream, x, weighted, symmetric, ',');
-    else if (format=="tsv") writeGraphEdgelistFormat(stream, x, weighted, symmetric, '\t');
-    else if (format=="adj") writeGraphAdjFormat(stream, x);
-    else throw std::runtime_error("Unknown output format: \'" + format + "\'");
+  if (format=="bin") {
+    writeGraphBinaryFormatOmp(file.c_str(), x, weighted, symmetric);
+    return;
   }
-  else {
-    if (format=="mtx") writeGraphMtxFormatOmp(stream, x, weighted, symmetric);
-    else if (format=="coo") writeGraphCooFormatOmp(stream, x, weighted, symmetric);
-    else if (format=="edgelist") writeGraphEdgelistFormatOmp(stream, x, weighted, symmetric);
-    else if (format=="csv") writeGraphEdgelistFormatOmp(stream, x, weighted, symmetric, ',');
-    else if (format=="tsv") writeGraphEdgelistFormatOmp(stream, x, weighted, symmetric, '\t');
-    else if (format=="adj") writeGraphAdjFormat(stream, x);
+  if (!sequential) {
+    if (format=="mtx") writeGraphMtxFormatOmp(file.c_str(), x, weighted, symmetric);
+    else if (format=="coo") writeGraphCooFormatOmp(file.c_str(), x, weighted, symmetric);
+    else if (format=="edgelist") writeGraphEdgelistFormatOmp(file.c_str(), x, weighted, symmetric);
+    else if (format=="csv") writeGraphEdgelistFormatOmp(file.c_str(), x, weighted, symmetric, ',');
+    else if (format=="tsv") writeGraphEdgelistFormatOmp(file.c_str(), x, weighted, symmetric, '\t');
+    else if (format=="adj") writeGraphAdjFormatOmp(file.c_str(), x);
     else throw std::runtime_error("Unknown output format: \'" + format + "\'");
+    return;
   }
+  ofstream stream(file.c_str());
+  if (format=="mtx") writeGraphMtxFormat(stream, x, weighted, symmetric);
+  else if (format=="coo") writeGraphCooFormat(stream, x, weighted, symmetric);
+  else if (format=="edgelist") writeGraphEdgelistFormat(stream, x, weighted, symmetric);
+  else if (format=="csv") writeGraphEdgelistFormat(stream, x, weighted, symmetric, ',');
+  else if (format=="tsv") writeGraphEdgelistFormat(stream, x, weighted, symmetric, '\t');
+  else if (format=="adj") writeGraphAdjFormat(stream, x);
+  else throw std::runtime_error("Unknown output format: \'" + format + "\'");
   stream.close();
 }
 
 
+/**
+ * Write the specified output graph to a number of files, concurrently.
+ * @param x graph to write (input)
+ * @param files output file names
+ * @param formats output file formats
+ * @param sequential write sequentially? [false]
+ * @param weighted is graph weighted? [false]
+ * @param symmetric is graph symmetric? [false]
+ * @note The threads are split among the files, so that the formatting of
+ * one file overlaps with the writing of another to disk.
+ */
+template <class G>
+inline void writeGraphs(const G& x, const vector<string>& files, const vector<string>& formats, bool sequential=false, bool weighted=false, bool symmetric=false) {
+  int F = int(files.size());
+  int T = omp_get_max_threads();
+  int H = min(F, T);
+  if (H<=1) {
+    for (int i=0; i<F; ++i)
+      writeGraph(x, files[i], formats[i], sequential, weighted, symmetric);
+    return;
+  }
+  vector<string> errors(F);
+  int levels = omp_get_max_active_levels();
+  omp_set_max_active_levels(max(levels, 2));
+  #pragma omp parallel for num_threads(H) schedule(dynamic, 1)
+  for (int i=0; i<F; ++i) {
+    omp_set_num_threads(max(1, T/H));
+    try { writeGraph(x, files[i], formats[i], sequential, weighted, symmetric); }
+    catch (const std::exception& e) { errors[i] = e.what(); }
+  }
+  omp_set_max_active_levels(levels);
+  for (int i=0; i<F; ++i)
+    if (!errors[i].empty()) throw std::runtime_error(errors[i]);
+}
+
+
 /**
  * Show certain properties of the graph.
  * @param x given graph
@@ -114,6 +371,108 @@ inline void showGraphProperties(const G& x, bool weighted=false, bool symmetric=
 
 
 #pragma region RUN COMMANDS
+/**
+ * Show and/or write the per-phase profile of a command.
+ * @param p profiler with measured phases
+ * @param command name of the command
+ * @param show show the profile on stdout?
+ * @param file JSON output file name (empty for none)
+ */
+inline void writeProfile(const Profiler& p, const string& command, bool show, const string& file) {
+  if (show) {
+    printf("Profile of %s:\n", command.c_str());
+    fflush(stdout);
+    p.write(cout);
+    cout << endl;
+  }
+  if (file.empty()) return;
+  ofstream stream(file.c_str());
+  p.writeJson(stream, command);
+  if (!stream) throw std::runtime_error("Failed to write profile: " + file);
+  printf("Profile written to \'%s\'.\n\n", file.c_str());
+}
+
+
+/**
+ * Read the specified input graph, symmetrize it if needed, and process it.
+ * @param p profiler for phases (updated)
+ * @param file input file name
+ * @param format input file format
+ * @param weighted is graph weighted?
+ * @param symmetric is graph symmetric?
+ * @param fc process function (symmetric graph)
+ */
+template <class K, class E, class FC>
+inline void readSymmetricGraphDo(Profiler& p, const string& file, const string& format, bool weighted, bool symmetric, FC fc) {
+  size_t bytes = fileSize(file.c_str());
+  printf("Reading graph \'%s\' ...\n", file.c_str());
+  if (format=="bin" && symmetric) {
+    DiGraphCsrView<K, None, E> x;
+    auto& r = p.measure("read", [&]() { mapGraphBinaryFormatW(x, file.c_str()); });
+    r.edges = x.size(); r.bytes = bytes;
+    showGraphProperties(x, weighted, symmetric);
+    fc(x);
+    return;
+  }
+  if (format!="bin" && format!="adj") {
+    // Symmetrize graph while reading, if needed.
+    DiGraphCsr<K, None, E> x;
+    if (!symmetric) printf("Symmetrizing graph while reading ...\n");
+    auto& r = p.measure("read", [&]() { readGraphCsrW(x, file, format, weighted, symmetric, !symmetric); });
+    r.edges = x.size(); r.bytes = bytes;
+    showGraphProperties(x, weighted, true);
+    fc(x);
+    return;
+  }
+  DiGraph<K, None, E> x;
+  auto& r = p.measure("read", [&]() { readGraphW(x, file, format, weighted, symmetric); });
+  r.edges = x.size(); r.bytes = bytes;
+  showGraphProperties(x, weighted, symmetric);
+  // Symmetrize graph.
+  if (!symmetric) {
+    printf("Symmetrizing graph ...\n");
+    p.measure("symmetrize", [&]() { symmetrizeOmpU(x); }).edges = x.size();
+    showGraphProperties(x, weighted, true);
+  }
+  fc(x);
+}
+
+
+/**
+ * Run the count-disconnected-communities command, with the given key and edge value types.
+ * @tparam K type of vertex ids
+ * @tparam E type of edge weights
+ * @param o command-line options
+ * @returns zero on success, non-zero on failure
+ */
+template <class K, class E>
+inline int runCountDisconnectedCommunitiesDo(const OptionsCountDisconnectedCommunities& o) {
+  Profiler p(o.profile || !o.profileFile.empty());
+  // Count the number of disconnected communities in a symmetric graph.
+  auto fc = [&](const auto& x) {
+    // Read community membership.
+    vector<K> membership(x.span());
+    printf("Reading community membership \'%s\' ...\n", o.membershipFile.c_str());
+    p.measure("read-membership", [&]() {
+      ifstream membershipStream(o.membershipFile.c_str());
+      readVectorW(membership, membershipStream, o.membershipKeyed, o.membershipStart);
+    }).bytes = fileSize(o.membershipFile.c_str());
+    // Count the number of disconnected communities.
+    size_t ncom = 0, ndis = 0;
+    p.measure("count-disconnected", [&]() {
+      ncom = communities(x, membership).size();
+      ndis = countValue(communitiesDisconnectedOmp(x, membership), char(1));
+    }).edges = x.size();
+    printf("Number of communities: %zu\n", ncom);
+    printf("Number of disconnected communities: %zu\n", ndis);
+    printf("\n");
+  };
+  readSymmetricGraphDo<K, E>(p, o.inputFile, o.inputFormat, o.weighted, o.symmetric, fc);
+  writeProfile(p, "count-disconnected-communities", o.profile, o.profileFile);
+  return 0;
+}
+
+
 /**
  * Run the count-disconnected-communities command.
  * @param argc argument count
@@ -122,105 +481,246 @@ inline void showGraphProperties(const G& x, bool weighted=false, bool symmetric=
  * @returns zero on success, non-zero on failure
  */
 inline int runCountDisconnectedCommunities(int argc, char **argv, int i=1) {
-  using K = KEY_TYPE;
-  using E = EDGE_VALUE_TYPE;
   using Options = OptionsCountDisconnectedCommunities;
   // Parse command-line arguments.
   Options o = parseCountDisconnectedCommunities(argc, argv, i);
   if (o.help) { helpCountDisconnectedCommunities(argv[0]); return 1; }
   if (!o.valid) return 1;
-  // Read input graph.
-  DiGraph<K, None, E> x;
-  printf("Reading graph \'%s\' ...\n", o.inputFile.c_str());
-  readGraphW(x, o.inputFile, o.inputFormat, o.weighted, o.symmetric);
-  showGraphProperties(x, o.weighted, o.symmetric);
-  // Symmetrize graph.
-  if (!o.symmetric) {
-    printf("Symmetrizing graph ...\n");
-    symmetrizeOmpU(x);
-    showGraphProperties(x, o.weighted, true);
-  }
-  // Read community membership.
-  vector<K> membership(x.span());
-  ifstream membershipStream(o.membershipFile.c_str());
-  printf("Reading community membership \'%s\' ...\n", o.membershipFile.c_str());
-  readVectorW(membership, membershipStream, o.membershipKeyed, o.membershipStart);
-  // Count the number of disconnected communities.
-  auto fc = [&](auto u) { return membership[u]; };
-  size_t ncom = communities(x, membership).size();
-  size_t ndis = countValue(communitiesDisconnectedOmp(x, membership), char(1));
-  printf("Number of communities: %zu\n", ncom);
-  printf("Number of disconnected communities: %zu\n", ndis);
-  printf("\n");
+  // Run with the key and edge value types needed by the graph.
+  auto t  = readGraphTypes(o.inputFile, o.inputFormat);
+  auto fn = [&](auto k, auto e) { return runCountDisconnectedCommunitiesDo<decltype(k), decltype(e)>(o); };
+  return runWithGraphTypes(t, fn);
+}
+
+
+/**
+ * Run the count-components command, with the given key and edge value types.
+ * @tparam K type of vertex ids
+ * @tparam E type of edge weights
+ * @param o command-line options
+ * @returns zero on success, non-zero on failure
+ */
+template <class K, class E>
+inline int runCountComponentsDo(const OptionsCountComponents& o) {
+  Profiler p(o.profile || !o.profileFile.empty());
+  // Count the number of connected components in a symmetric graph.
+  auto fc = [&](const auto& x) {
+    const size_t TOP = 10;
+    vector<size_t> sizes;
+    p.measure("count-components", [&]() {
+      auto comp = componentsAfforestOmp(x);
+      sizes = componentSizesOmp(x, comp);
+    }).edges = x.size();
+    size_t nsin = 0;
+    for (size_t n : sizes)
+      if (n==1) ++nsin;
+    printf("Number of components: %zu\n", sizes.size());
+    printf("Number of singleton components: %zu\n", nsin);
+    printf("Largest component sizes:");
+    for (size_t c=0; c<sizes.size() && c<TOP; ++c)
+      printf(" %zu", sizes[c]);
+    printf("\n");
+    printf("\n");
+  };
+  readSymmetricGraphDo<K, E>(p, o.inputFile, o.inputFormat, o.weighted, o.symmetric, fc);
+  writeProfile(p, "count-components", o.profile, o.profileFile);
   return 0;
 }
 
 
 /**
- * Run the make-undirected command.
+ * Run the count-components command.
  * @param argc argument count
  * @param argv argument values
  * @param i start index of arguments [1]
  * @returns zero on success, non-zero on failure
  */
-inline int runMakeUndirected(int argc, char **argv, int i=1) {
-  using K = KEY_TYPE;
-  using E = EDGE_VALUE_TYPE;
-  using Options = OptionsMakeUndirected;
+inline int runCountComponents(int argc, char **argv, int i=1) {
+  using Options = OptionsCountComponents;
   // Parse command-line arguments.
-  Options o = parseOptionsMakeUndirected(argc, argv, i);
-  if (o.help) { helpMakeUndirected(argv[0]); return 1; }
+  Options o = parseCountComponents(argc, argv, i);
+  if (o.help) { helpCountComponents(argv[0]); return 1; }
   if (!o.valid) return 1;
+  // Run with the key and edge value types needed by the graph.
+  auto t  = readGraphTypes(o.inputFile, o.inputFormat);
+  auto fn = [&](auto k, auto e) { return runCountComponentsDo<decltype(k), decltype(e)>(o); };
+  return runWithGraphTypes(t, fn);
+}
+
+
+/**
+ * Run the make-undirected command, with the given key and edge value types.
+ * @tparam K type of vertex ids
+ * @tparam E type of edge weights
+ * @param o command-line options
+ * @returns zero on success, non-zero on failure
+ */
+template <class K, class E>
+inline int runMakeUndirectedDo(const OptionsMakeUndirected& o) {
+  Profiler p(o.profile || !o.profileFile.empty());
+  // Stream graph through disk, if memory is limited.
+  if (o.memoryLimit) {
+    size_t n = 0, m = 0;
+    printf("Streaming undirected graph \'%s\' to \'%s\' ...\n", o.inputFile.c_str(), o.outputFile.c_str());
+    auto& r = p.measure("stream", [&]() {
+      tie(n, m) = streamGraphW<K, E>(o.inputFile, o.inputFormat, o.outputFile, o.outputFormat, o.memoryLimit, o.inputWeighted, o.inputSymmetric, o.outputWeighted, o.outputSymmetric, true, false);
+    });
+    r.edges = m; r.bytes = fileSize(o.inputFile.c_str()) + fileSize(o.outputFile.c_str());
+    printf("> |V|: %zu, |E|: %zu, Weighted: %s, Symmetric: %s\n", n, m, o.outputWeighted? "yes" : "no", o.outputSymmetric? "yes" : "no");
+    printf("Undirected graph written to \'%s\'.\n", o.outputFile.c_str());
+    printf("\n");
+    writeProfile(p, "make-undirected", o.profile, o.profileFile);
+    return 0;
+  }
   // Read input graph.
   DiGraph<K, None, E> x;
   printf("Reading graph \'%s\' ...\n", o.inputFile.c_str());
-  readGraphW(x, o.inputFile, o.inputFormat, o.inputWeighted, o.inputSymmetric);
+  auto& r = p.measure("read", [&]() { readGraphW(x, o.inputFile, o.inputFormat, o.inputWeighted, o.inputSymmetric); });
+  r.edges = x.size(); r.bytes = fileSize(o.inputFile.c_str());
   showGraphProperties(x, o.inputWeighted, o.inputSymmetric);
   // Symmetrize graph.
   if (!o.inputSymmetric) {
     printf("Symmetrizing graph ...\n");
-    symmetrizeOmpU(x);
+    p.measure("symmetrize", [&]() { symmetrizeOmpU(x); }).edges = x.size();
     showGraphProperties(x, o.inputWeighted, true);
   }
   // Write undirected graph.
   printf("Writing undirected graph \'%s\' ...\n", o.outputFile.c_str());
-  writeGraph(x, o.outputFile, o.outputFormat, o.outputSequential, o.outputWeighted, o.outputSymmetric);
+  auto& s = p.measure("write", [&]() { writeGraph(x, o.outputFile, o.outputFormat, o.outputSequential, o.outputWeighted, o.outputSymmetric); });
+  s.edges = x.size(); s.bytes = fileSize(o.outputFile.c_str());
   printf("Undirected graph written to \'%s\'.\n", o.outputFile.c_str());
   printf("\n");
+  writeProfile(p, "make-undirected", o.profile, o.profileFile);
   return 0;
 }
 
 
 /**
- * Run the add-self-loops command.
+ * Run the make-undirected command.
  * @param argc argument count
  * @param argv argument values
  * @param i start index of arguments [1]
  * @returns zero on success, non-zero on failure
  */
-inline int runAddSelfLoops(int argc, char **argv, int i=1) {
-  using K = KEY_TYPE;
-  using E = EDGE_VALUE_TYPE;
-  using Options = OptionsAddSelfLoops;
+inline int runMakeUndirected(int argc, char **argv, int i=1) {
+  using Options = OptionsMakeUndirected;
   // Parse command-line arguments.
-  Options o = parseOptionsAddSelfLoops(argc, argv, i);
-  if (o.help) { helpAddSelfLoops(argv[0]); return 1; }
+  Options o = parseOptionsMakeUndirected(argc, argv, i);
+  if (o.help) { helpMakeUndirected(argv[0]); return 1; }
   if (!o.valid) return 1;
+  // Run with the key and edge value types needed by the graph.
+  auto t  = readGraphTypes(o.inputFile, o.inputFormat, 0, o.outputWeighted, o.doubleWeights);
+  auto fn = [&](auto k, auto e) { return runMakeUndirectedDo<decltype(k), decltype(e)>(o); };
+  return runWithGraphTypes(t, fn);
+}
+
+
+/**
+ * Run the add-self-loops command, with the given key and edge value types.
+ * @tparam K type of vertex ids
+ * @tparam E type of edge weights
+ * @param o command-line options
+ * @returns zero on success, non-zero on failure
+ */
+template <class K, class E>
+inline int runAddSelfLoopsDo(const OptionsAddSelfLoops& o) {
+  Profiler p(o.profile || !o.profileFile.empty());
+  // Stream graph through disk, if memory is limited.
+  if (o.memoryLimit) {
+    size_t n = 0, m = 0;
+    printf("Streaming graph with self-loops \'%s\' to \'%s\' ...\n", o.inputFile.c_str(), o.outputFile.c_str());
+    auto& r = p.measure("stream", [&]() {
+      tie(n, m) = streamGraphW<K, E>(o.inputFile, o.inputFormat, o.outputFile, o.outputFormat, o.memoryLimit, o.inputWeighted, o.inputSymmetric, o.outputWeighted, o.outputSymmetric, false, true);
+    });
+    r.edges = m; r.bytes = fileSize(o.inputFile.c_str()) + fileSize(o.outputFile.c_str());
+    printf("> |V|: %zu, |E|: %zu, Weighted: %s, Symmetric: %s\n", n, m, o.outputWeighted? "yes" : "no", o.outputSymmetric? "yes" : "no");
+    printf("Graph with self-loops written to \'%s\'.\n", o.outputFile.c_str());
+    printf("\n");
+    writeProfile(p, "add-self-loops", o.profile, o.profileFile);
+    return 0;
+  }
   // Read input graph.
   DiGraph<K, None, E> x;
   printf("Reading graph \'%s\' ...\n", o.inputFile.c_str());
-  readGraphW(x, o.inputFile, o.inputFormat, o.inputWeighted, o.inputSymmetric);
+  auto& r = p.measure("read", [&]() { readGraphW(x, o.inputFile, o.inputFormat, o.inputWeighted, o.inputSymmetric); });
+  r.edges = x.size(); r.bytes = fileSize(o.inputFile.c_str());
   showGraphProperties(x, o.inputWeighted, o.inputSymmetric);
   // Add self-loops.
   printf("Adding self-loops ...\n");
   auto ft = [](auto u) { return true; };
-  addSelfLoopsOmpU(x, E(1), ft);
+  p.measure("add-self-loops", [&]() { addSelfLoopsOmpU(x, E(1), ft); }).edges = x.size();
   showGraphProperties(x, o.inputWeighted, o.inputSymmetric);
   // Write graph with self-loops.
   printf("Writing graph with self-loops \'%s\' ...\n", o.outputFile.c_str());
-  writeGraph(x, o.outputFile, o.outputFormat, o.outputWeighted, o.outputSymmetric);
+  auto& s = p.measure("write", [&]() { writeGraph(x, o.outputFile, o.outputFormat, o.outputSequential, o.outputWeighted, o.outputSymmetric); });
+  s.edges = x.size(); s.bytes = fileSize(o.outputFile.c_str());
   printf("Graph with self-loops written to \'%s\'.\n", o.outputFile.c_str());
   printf("\n");
+  writeProfile(p, "add-self-loops", o.profile, o.profileFile);
+  return 0;
+}
+
+
+/**
+ * Run the add-self-loops command.
+ * @param argc argument count
+ * @param argv argument values
+ * @param i start index of arguments [1]
+ * @returns zero on success, non-zero on failure
+ */
+inline int runAddSelfLoops(int argc, char **argv, int i=1) {
+  using Options = OptionsAddSelfLoops;
+  // Parse command-line arguments.
+  Options o = parseOptionsAddSelfLoops(argc, argv, i);
+  if (o.help) { helpAddSelfLoops(argv[0]); return 1; }
+  if (!o.valid) return 1;
+  // Run with the key and edge value types needed by the graph.
+  auto t  = readGraphTypes(o.inputFile, o.inputFormat, 0, o.outputWeighted, o.doubleWeights);
+  auto fn = [&](auto k, auto e) { return runAddSelfLoopsDo<decltype(k), decltype(e)>(o); };
+  return runWithGraphTypes(t, fn);
+}
+
+
+/**
+ * Run the no-operation command, with the given key and edge value types.
+ * @tparam K type of vertex ids
+ * @tparam E type of edge weights
+ * @param o command-line options
+ * @returns zero on success, non-zero on failure
+ */
+template <class K, class E>
+inline int runNoOperationDo(const OptionsNoOperation& o) {
+  Profiler p(o.profile || !o.profileFile.empty());
+  size_t bytes = fileSize(o.inputFile.c_str());
+  // Read input graph, and write output graph.
+  auto fw = [&](const auto& x) {
+    showGraphProperties(x, o.inputWeighted, o.inputSymmetric);
+    printf("Writing graph \'%s\' ...\n", o.outputFile.c_str());
+    auto& s = p.measure("write", [&]() { writeGraph(x, o.outputFile, o.outputFormat, o.outputSequential, o.outputWeighted, o.outputSymmetric); });
+    s.edges = x.size(); s.bytes = fileSize(o.outputFile.c_str());
+    printf("Graph written to \'%s\'.\n", o.outputFile.c_str());
+    printf("\n");
+  };
+  printf("Reading graph \'%s\' ...\n", o.inputFile.c_str());
+  if (o.inputFormat=="bin") {
+    DiGraphCsrView<K, None, E> x;
+    auto& r = p.measure("read", [&]() { mapGraphBinaryFormatW(x, o.inputFile.c_str()); });
+    r.edges = x.size(); r.bytes = bytes;
+    fw(x);
+  }
+  else if (o.inputFormat!="adj") {
+    DiGraphCsr<K, None, E> x;
+    auto& r = p.measure("read", [&]() { readGraphCsrW(x, o.inputFile, o.inputFormat, o.inputWeighted, o.inputSymmetric); });
+    r.edges = x.size(); r.bytes = bytes;
+    fw(x);
+  }
+  else {
+    DiGraph<K, None, E> x;
+    auto& r = p.measure("read", [&]() { readGraphW(x, o.inputFile, o.inputFormat, o.inputWeighted, o.inputSymmetric); });
+    r.edges = x.size(); r.bytes = bytes;
+    fw(x);
+  }
+  writeProfile(p, "no-operation", o.profile, o.profileFile);
   return 0;
 }
 
@@ -233,25 +733,381 @@ inline int runAddSelfLoops(int argc, char **argv, int i=1) {
  * @returns zero on success, non-zero on failure
  */
 inline int runNoOperation(int argc, char **argv, int i=1) {
-  using K = KEY_TYPE;
-  using E = EDGE_VALUE_TYPE;
   using Options = OptionsNoOperation;
   // Parse command-line arguments.
   Options o = parseOptionsNoOperation(argc, argv, i);
   if (o.help) { helpNoOperation(argv[0]); return 1; }
   if (!o.valid) return 1;
+  // Run with the key and edge value types needed by the graph.
+  auto t  = readGraphTypes(o.inputFile, o.inputFormat, 0, o.outputWeighted, o.doubleWeights);
+  auto fn = [&](auto k, auto e) { return runNoOperationDo<decltype(k), decltype(e)>(o); };
+  return runWithGraphTypes(t, fn);
+}
+
+/**
+ * Run the generate command, with the given key and edge value types.
+ * @tparam K type of vertex ids
+ * @tparam E type of edge weights
+ * @param o command-line options
+ * @returns zero on success, non-zero on failure
+ */
+template <class K, class E>
+inline int runGenerateDo(const OptionsGenerate& o) {
+  Profiler p(o.profile || !o.profileFile.empty());
+  // Generate the edges of the random graph.
+  vector2d<tuple<K, K, E>> edges;
+  size_t N = 0, M = 0;
+  printf("Generating %s graph ...\n", o.kind.c_str());
+  auto& r = p.measure("generate", [&]() { N = generateEdgesW(edges, o, o.outputWeighted); });
+  for (const auto& es : edges)
+    M += es.size();
+  r.edges = M;
+  // Build the graph, removing duplicate edges.
+  DiGraphCsr<K, None, E> x;
+  p.measure("build", [&]() { generateGraphCsrOmpW(x, edges, N, o.undirected); }).edges = M;
+  edges.clear();
+  showGraphProperties(x, o.outputWeighted, o.undirected);
+  // Write the random graph.
+  printf("Writing graph \'%s\' ...\n", o.outputFile.c_str());
+  auto& s = p.measure("write", [&]() { writeGraph(x, o.outputFile, o.outputFormat, o.outputSequential, o.outputWeighted, o.outputSymmetric); });
+  s.edges = x.size(); s.bytes = fileSize(o.outputFile.c_str());
+  printf("Graph written to \'%s\'.\n", o.outputFile.c_str());
+  printf("\n");
+  writeProfile(p, "generate", o.profile, o.profileFile);
+  return 0;
+}
+
+
+/**
+ * Run the generate command.
+ * @param argc argument count
+ * @param argv argument values
+ * @param i start index of arguments [1]
+ * @returns zero on success, non-zero on failure
+ */
+inline int runGenerate(int argc, char **argv, int i=1) {
+  using Options = OptionsGenerate;
+  // Parse command-line arguments.
+  Options o = parseOptionsGenerate(argc, argv, i);
+  if (o.help) { helpGenerate(argv[0]); return 1; }
+  if (!o.valid) return 1;
+  // Run with the key and edge value types needed by the graph.
+  // R-MAT rounds up the number of vertices to a power of 2.
+  size_t S = (o.kind=="rmat"? 2*o.vertices : o.vertices) + 1;
+  auto t  = readGraphTypes("", "", S, o.outputWeighted, o.doubleWeights);
+  auto fn = [&](auto k, auto e) { return runGenerateDo<decltype(k), decltype(e)>(o); };
+  return runWithGraphTypes(t, fn);
+}
+
+
+/**
+ * Run the reorder command, with the given key and edge value types.
+ * @tparam K type of vertex ids
+ * @tparam E type of edge weights
+ * @param o command-line options
+ * @returns zero on success, non-zero on failure
+ */
+template <class K, class E>
+inline int runReorderDo(const OptionsReorder& o) {
+  Profiler p(o.profile || !o.profileFile.empty());
+  size_t bytes = fileSize(o.inputFile.c_str());
+  // Reorder the vertices of the graph, and write it.
+  auto fr = [&](const auto& x) {
+    showGraphProperties(x, o.inputWeighted, o.inputSymmetric);
+    // Read community membership, if needed.
+    vector<K> membership;
+    if (o.order=="community") {
+      printf("Reading community membership \'%s\' ...\n", o.membershipFile.c_str());
+      p.measure("read-membership", [&]() {
+        ifstream membershipStream(o.membershipFile.c_str());
+        readVectorW(membership, membershipStream, o.membershipKeyed, o.membershipStart);
+        membership.resize(max(membership.size(), x.span()));
+      }).bytes = fileSize(o.membershipFile.c_str());
+    }
+    // Obtain the new id of each vertex.
+    vector<K> ids;
+    printf("Ordering vertices by %s ...\n", o.order.c_str());
+    p.measure("order", [&]() {
+      vector<K> order;
+      if (o.order=="degree") order = degreeOrderOmp(x);
+      else if (o.order=="bfs") order = cuthillMcKeeOrderOmp(x, false, false, o.inputSymmetric);
+      else if (o.order=="cm")  order = cuthillMcKeeOrderOmp(x, true,  false, o.inputSymmetric);
+      else if (o.order=="rcm") order = cuthillMcKeeOrderOmp(x, true,  true,  o.inputSymmetric);
+      else if (o.order=="community") order = communityOrderOmp(x, membership);
+      ids = reorderIdsOmp(x, order);
+    }).edges = x.size();
+    // Relabel the graph.
+    DiGraphCsr<K, None, E> y;
+    p.measure("relabel", [&]() { relabelCsrOmpW(y, x, ids); }).edges = x.size();
+    printf("> Average log gap: %.3f before, %.3f after\n", averageLogGapOmp(x), averageLogGapOmp(y));
+    printf("\n");
+    // Write the reordered graph.
+    printf("Writing reordered graph \'%s\' ...\n", o.outputFile.c_str());
+    auto& s = p.measure("write", [&]() { writeGraph(y, o.outputFile, o.outputFormat, o.outputSequential, o.outputWeighted, o.outputSymmetric); });
+    s.edges = y.size(); s.bytes = fileSize(o.outputFile.c_str());
+    printf("Reordered graph written to \'%s\'.\n", o.outputFile.c_str());
+    // Write the new id of each vertex.
+    if (!o.permutationFile.empty()) {
+      ofstream stream(o.permutationFile.c_str());
+      x.forEachVertexKey([&](auto u) { stream << u << ' ' << ids[u] << '\n'; });
+      printf("Vertex permutation written to \'%s\'.\n", o.permutationFile.c_str());
+    }
+    // Reorder the vertex vectors (new ids reuse the ids of existing vertices).
+    for (const auto& file : o.vectorFiles) {
+      vector<string> a, b(x.span());
+      ifstream istream(file.c_str());
+      readVectorW(a, istream, o.membershipKeyed, o.membershipStart);
+      size_t N = 0, M = 0;
+      for (const auto& v : a)
+        if (!v.empty()) ++N;
+      x.forEachVertexKey([&](auto u) {
+        if (u>=a.size() || a[u].empty()) return;
+        b[ids[u]] = a[u]; ++M;
+      });
+      if (N!=M || M!=x.order()) {
+        string msg = "Vector \'" + file + "\' has " + to_string(N) + " entries, " + to_string(M) + " of them for the " + to_string(x.order()) + " vertices";
+        if (!o.membershipKeyed) throw std::runtime_error(msg + " (check --membership-start)");
+        fprintf(stderr, "Warning: %s; writing only those.\n", msg.c_str());
+      }
+      ofstream ostream((file + ".reordered").c_str());
+      auto ft = [&](size_t v) { return !b[v].empty(); };
+      writeVectorIf(ostream, b, o.membershipKeyed, o.membershipStart, ft);
+      printf("Reordered vector written to \'%s\'.\n", (file + ".reordered").c_str());
+    }
+    printf("\n");
+  };
+  printf("Reading graph \'%s\' ...\n", o.inputFile.c_str());
+  if (o.inputFormat=="bin") {
+    DiGraphCsrView<K, None, E> x;
+    auto& r = p.measure("read", [&]() { mapGraphBinaryFormatW(x, o.inputFile.c_str()); });
+    r.edges = x.size(); r.bytes = bytes;
+    fr(x);
+  }
+  else if (o.inputFormat!="adj") {
+    DiGraphCsr<K, None, E> x;
+    auto& r = p.measure("read", [&]() { readGraphCsrW(x, o.inputFile, o.inputFormat, o.inputWeighted, o.inputSymmetric); });
+    r.edges = x.size(); r.bytes = bytes;
+    fr(x);
+  }
+  else {
+    DiGraph<K, None, E> x;
+    auto& r = p.measure("read", [&]() { readGraphW(x, o.inputFile, o.inputFormat, o.inputWeighted, o.inputSymmetric); });
+    r.edges = x.size(); r.bytes = bytes;
+    fr(x);
+  }
+  writeProfile(p, "reorder", o.profile, o.profileFile);
+  return 0;
+}
+
+
+/**
+ * Run the reorder command.
+ * @param argc argument count
+ * @param argv argument values
+ * @param i start index of arguments [1]
+ * @returns zero on success, non-zero on failure
+ */
+inline int runReorder(int argc, char **argv, int i=1) {
+  using Options = OptionsReorder;
+  // Parse command-line arguments.
+  Options o = parseOptionsReorder(argc, argv, i);
+  if (o.help) { helpReorder(argv[0]); return 1; }
+  if (!o.valid) return 1;
+  // Run with the key and edge value types needed by the graph.
+  auto t  = readGraphTypes(o.inputFile, o.inputFormat, 0, o.outputWeighted, o.doubleWeights);
+  auto fn = [&](auto k, auto e) { return runReorderDo<decltype(k), decltype(e)>(o); };
+  return runWithGraphTypes(t, fn);
+}
+
+
+/**
+ * Run the pipeline command, with the given key and edge value types.
+ * @tparam K type of vertex ids
+ * @tparam E type of edge weights
+ * @param o command-line options
+ * @returns zero on success, non-zero on failure
+ */
+template <class K, class E>
+inline int runPipelineDo(const OptionsPipeline& o) {
+  Profiler p(o.profile || !o.profileFile.empty());
+  bool symmetric = o.inputSymmetric;
   // Read input graph.
   DiGraph<K, None, E> x;
   printf("Reading graph \'%s\' ...\n", o.inputFile.c_str());
-  readGraphW(x, o.inputFile, o.inputFormat, o.inputWeighted, o.inputSymmetric);
-  showGraphProperties(x, o.inputWeighted, o.inputSymmetric);
-  // Write output graph.
-  printf("Writing graph \'%s\' ...\n", o.outputFile.c_str());
-  writeGraph(x, o.outputFile, o.outputFormat, o.outputWeighted, o.outputSymmetric);
-  printf("Graph written to \'%s\'.\n", o.outputFile.c_str());
+  auto& r = p.measure("read", [&]() { readGraphW(x, o.inputFile, o.inputFormat, o.inputWeighted, o.inputSymmetric); });
+  r.edges = x.size(); r.bytes = fileSize(o.inputFile.c_str());
+  showGraphProperties(x, o.inputWeighted, symmetric);
+  // Steps that only add or remove edges leave the graph to be updated once,
+  // just before a step that reads its edges, or at the end.
+  bool pending = false;
+  auto fu = [&]() {
+    if (!pending) return;
+    p.measure("update", [&]() { updateOmpU(x); }).edges = x.size();
+    pending = false;
+  };
+  auto fw = [](auto w) {
+    if constexpr (is_same<decltype(w), None>::value) return 1.0;
+    else return double(w);
+  };
+  for (const auto& step : o.steps) {
+    size_t c = step.find(':');
+    string name = step.substr(0, c);
+    string arg  = c==string::npos? "" : step.substr(c+1);
+    printf("Applying %s ...\n", step.c_str());
+    if (name=="symmetrize") {
+      fu();
+      p.measure(name, [&]() { symmetrizeLazyOmpU(x); }).edges = x.size();
+      pending = symmetric = true;
+    }
+    else if (name=="add-self-loops") {
+      auto ft = [](auto u) { return true; };
+      p.measure(name, [&]() { addSelfLoopsLazyOmpU(x, E(1), ft); }).edges = x.order();
+      pending = true;
+    }
+    else if (name=="remove-self-loops") {
+      auto ft = [](auto u) { return true; };
+      p.measure(name, [&]() { removeSelfLoopsLazyOmpU(x, ft); }).edges = x.order();
+      pending = true;
+    }
+    else if (name=="transpose") {
+      fu();
+      DiGraph<K, None, E> y;
+      p.measure(name, [&]() { transposeOmpW(y, x); }).edges = y.size();
+      x = move(y);
+    }
+    else if (name=="min-weight" || name=="max-weight") {
+      fu();
+      double t = strtod(arg.c_str(), nullptr);
+      bool   l = name=="min-weight";
+      auto  fv = [](auto u, auto d) { return true; };
+      auto  fe = [&](auto u, auto v, auto w) { return l? fw(w)>=t : fw(w)<=t; };
+      DiGraph<K, None, E> y;
+      p.measure(name, [&]() { duplicateIfOmpW(y, x, fv, fe); }).edges = x.size();
+      x = move(y);
+    }
+    else if (name=="batch") {
+      vector<tuple<K, K, E>> deletions, insertions;
+      p.measure("read-batch", [&]() {
+        ifstream stream(arg.c_str());
+        readBatchUpdateW(deletions, insertions, stream, o.inputWeighted);
+      }).bytes = fileSize(arg.c_str());
+      printf("> Deletions: %zu, Insertions: %zu\n", deletions.size(), insertions.size());
+      p.measure(name, [&]() { applyBatchUpdateLazyOmpU(x, deletions, insertions); }).edges = deletions.size() + insertions.size();
+      pending = true;
+      symmetric = false;
+    }
+  }
+  fu();
+  showGraphProperties(x, o.inputWeighted, symmetric);
+  // Write the output graph, to all output files at once.
+  size_t bytes = 0;
+  for (const auto& file : o.outputFiles)
+    printf("Writing graph \'%s\' ...\n", file.c_str());
+  auto& s = p.measure("write", [&]() { writeGraphs(x, o.outputFiles, o.outputFormats, o.outputSequential, o.outputWeighted, o.outputSymmetric); });
+  for (const auto& file : o.outputFiles) {
+    printf("Graph written to \'%s\'.\n", file.c_str());
+    bytes += fileSize(file.c_str());
+  }
+  s.edges = x.size() * o.outputFiles.size(); s.bytes = bytes;
   printf("\n");
+  writeProfile(p, "pipeline", o.profile, o.profileFile);
   return 0;
 }
+
+
+/**
+ * Run the pipeline command.
+ * @param argc argument count
+ * @param argv argument values
+ * @param i start index of arguments [1]
+ * @returns zero on success, non-zero on failure
+ */
+inline int runPipeline(int argc, char **argv, int i=1) {
+  using Options = OptionsPipeline;
+  // Parse command-line arguments.
+  Options o = parseOptionsPipeline(argc, argv, i);
+  if (o.help) { helpPipeline(argv[0]); return 1; }
+  if (!o.valid) return 1;
+  // Run with the key and edge value types needed by the graph, and its batch updates.
+  bool weighted = o.outputWeighted;
+  for (const auto& step : o.steps)
+    if (step.rfind("min-weight:", 0)==0 || step.rfind("max-weight:", 0)==0) weighted |= o.inputWeighted;
+  auto t  = readGraphTypes(o.inputFile, o.inputFormat, 0, weighted, o.doubleWeights);
+  for (const auto& step : o.steps)
+    if (step.rfind("batch:", 0)==0) t.keyBits = max(t.keyBits, readGraphTypes(step.substr(6), "edgelist").keyBits);
+  auto fn = [&](auto k, auto e) { return runPipelineDo<decltype(k), decltype(e)>(o); };
+  return runWithGraphTypes(t, fn);
+}
+
+
+/**
+ * Run the benchmark command, with the given key and edge value types.
+ * @tparam K type of vertex ids
+ * @tparam E type of edge weights
+ * @param o command-line options
+ * @returns zero on success, non-zero on failure
+ */
+template <class K, class E>
+inline int runBenchmarkDo(const OptionsBenchmark& o) {
+  // Load the edges of the input graph, or generate a random graph.
+  string text;
+  MappedFile data;
+  string_view body;
+  bool symmetric = o.symmetric;
+  if (o.inputFile.empty()) {
+    printf("Generating random graph with %zu vertices and %zu edges ...\n", o.vertices, o.edges);
+    text = generateRandomEdgelist(o.vertices, o.edges, o.weighted);
+    body = text;
+  }
+  else {
+    printf("Reading graph \'%s\' ...\n", o.inputFile.c_str());
+    data = MappedFile(o.inputFile.c_str());
+    body = data.view();
+    size_t rows = 0, cols = 0, size = 0, off = 0;
+    if (o.inputFormat=="mtx") off = readMtxFormatHeader(symmetric, rows, cols, size, body);
+    else if (o.inputFormat=="coo") off = readCooFormatHeaderW(rows, cols, size, body);
+    body = body.substr(off);
+  }
+  printf("> Input: %zu bytes, Weighted: %s, Symmetric: %s\n\n", body.size(), o.weighted? "yes" : "no", symmetric? "yes" : "no");
+  // Run each kernel a number of times, with each number of threads.
+  vector<int> threads = parseThreads(o.threads, omp_get_max_threads());
+  vector<BenchmarkResult> results;
+  auto fr = [&](const BenchmarkResult& r) {
+    if (!results.empty() && results.back().threads!=r.threads) printf("\n");
+    printf("> Threads %d, %s: median %.3f ms, stddev %.3f ms, %.3e edges/s, %.3e bytes/s\n", r.threads, r.kernel.c_str(), r.median, r.stddev, r.edgesPerSecond(), r.bytesPerSecond());
+    results.push_back(r);
+  };
+  benchmarkKernelsOmp<K, E>(body, threads, o.repeat, o.outputFile, fr, o.weighted, symmetric);
+  printf("\n");
+  // Write the results.
+  if (o.resultFile.empty()) return 0;
+  ofstream stream(o.resultFile.c_str());
+  writeBenchmarkResultsJson(stream, o.inputFile, results);
+  if (!stream) throw std::runtime_error("Failed to write benchmark results: " + o.resultFile);
+  printf("Benchmark results written to \'%s\'.\n\n", o.resultFile.c_str());
+  return 0;
+}
+
+
+/**
+ * Run the benchmark command.
+ * @param argc argument count
+ * @param argv argument values
+ * @param i start index of arguments [1]
+ * @returns zero on success, non-zero on failure
+ */
+inline int runBenchmark(int argc, char **argv, int i=1) {
+  using Options = OptionsBenchmark;
+  // Parse command-line arguments.
+  Options o = parseOptionsBenchmark(argc, argv, i);
+  if (o.help) { helpBenchmark(argv[0]); return 1; }
+  if (!o.valid) return 1;
+  // Run with the key and edge value types needed by the graph.
+  auto t  = readGraphTypes(o.inputFile, o.inputFormat, o.inputFile.empty()? o.vertices+1 : 0, o.weighted);
+  auto fn = [&](auto k, auto e) { return runBenchmarkDo<decltype(k), decltype(e)>(o); };
+  return runWithGraphTypes(t, fn);
+}
+
 #pragma endregion
 
 
@@ -281,9 +1137,14 @@ inline int helpMain(const char *name) {
   fprintf(stderr, "\n");
   fprintf(stderr, "Commands:\n");
   fprintf(stderr, "  count-disconnected-communities\n");
+  fprintf(stderr, "  count-components\n");
   fprintf(stderr, "  make-undirected\n");
   fprintf(stderr, "  add-self-loops\n");
+  fprintf(stderr, "  generate\n");
+  fprintf(stderr, "  reorder\n");
+  fprintf(stderr, "  pipeline\n");
   fprintf(stderr, "  no-operation\n");
+  fprintf(stderr, "  benchmark\n");
   fprintf(stderr, "\n");
   fprintf(stderr, "Options:\n");
   fprintf(stderr, "  --help     Show this help message.\n");
@@ -302,8 +1163,6 @@ inline int helpMain(const char *name) {
  * @returns zero on success, non-zero on failure
  */
 int main(int argc, char **argv) {
-  using K = KEY_TYPE;
-  using E = EDGE_VALUE_TYPE;
   // Initialize OpenMP.
   if (MAX_THREADS) omp_set_num_threads(MAX_THREADS);
   // Run the appropriate command.
@@ -311,9 +1170,14 @@ int main(int argc, char **argv) {
   if (cmd=="--help") return helpMain(argv[0]);
   else if (cmd=="--version") return showVersion(argv[0]);
   else if (cmd=="count-disconnected-communities") return runCountDisconnectedCommunities(argc, argv, 2);
+  else if (cmd=="count-components")               return runCountComponents(argc, argv, 2);
   else if (cmd=="make-undirected")                return runMakeUndirected(argc, argv, 2);
   else if (cmd=="add-self-loops")                 return runAddSelfLoops(argc, argv, 2);
+  else if (cmd=="generate")                       return runGenerate(argc, argv, 2);
+  else if (cmd=="reorder")                        return runReorder(argc, argv, 2);
+  else if (cmd=="pipeline")                       return runPipeline(argc, argv, 2);
   else if (cmd=="no-operation")                   return runNoOperation(argc, argv, 2);
+  else if (cmd=="benchmark")                      return runBenchmark(argc, argv, 2);
   fprintf(stderr, "Unknown command `%s`. See `%s --help` for a list of commands.\n\n", cmd.c_str(), argv[0]);
   return 1;
 }
@@ -13,14 +13,10 @@ if [[ "$DOWNLOAD" != "0" ]]; then
 fi
 
 # Fixed config
-: "${KEY_TYPE:=uint32_t}"
-: "${EDGE_VALUE_TYPE:=float}"
 : "${MAX_THREADS:=64}"
 : "${VERSION:=1.0.0}"
 # Define macros (dont forget to add here)
 DEFINES=(""
-"-DKEY_TYPE=$KEY_TYPE"
-"-DEDGE_VALUE_TYPE=$EDGE_VALUE_TYPE"
 "-DMAX_THREADS=$MAX_THREADS"
 "-DVERSION=\"$VERSION\""
 )
@@ -61,3 +57,23 @@ if [[ "$RUN" != "0" ]]; then
   runTool ~/Data/kmer_A2a.mtx        0 1
   runTool ~/Data/kmer_V1r.mtx        0 1
 fi
+
+# Benchmark tool kernels on a single graph
+runBenchmark() {
+  # $1: input file name (without extension)
+  # $2: is graph weighted (0/1)
+  # $3: is graph symmetric (0/1)
+  opt2=""
+  opt3=""
+  if [[ "$2" == "1" ]]; then opt2="-w"; fi
+  if [[ "$3" == "1" ]]; then opt3="-s"; fi
+  stdbuf --output=L ./a.out benchmark -i "$1" "$opt2" "$opt3" -o "$1.benchmark" -j "$1.benchmark.json" 2>&1 | tee -a "$out"
+}
+
+# Benchmark tool kernels on some graphs
+if [[ "$BENCHMARK" == "1" ]]; then
+  stdbuf --output=L ./a.out benchmark 2>&1 | tee -a "$out"
+  runBenchmark ~/Data/indochina-2004.mtx  0 0
+  runBenchmark ~/Data/com-LiveJournal.mtx 0 1
+  runBenchmark ~/Data/europe_osm.mtx      0 1
+fi